@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../07_hash/LinearProbingHash/map/HashMap.hpp"
+#include "StudentCsv.hpp"
+
+// A new grade of a registered student.
+struct GradeUpdate {
+    uint32_t student;
+    uint32_t grade;  // hundredths
+};
+
+// Averages of students whose grades keep arriving, searchable by average
+// while they change.
+//
+// Every student keeps a running sum and count. The averages are put in
+// fixed-point buckets of width 1 / buckets_per_unit; every bucket holds the
+// list of its students, and a Fenwick tree over the buckets counts the
+// students at or below any bucket. A new grade moves its student to the
+// bucket of the new average: two O(1) list updates and two O(log buckets)
+// tree updates, nothing is re-sorted. Queries:
+//   - countBetween: tree counts for the buckets in between, the two end
+//     buckets checked student by student
+//   - percentile / topK: the tree finds the bucket holding the wanted rank,
+//     only that bucket is ordered exactly (so a query costs about the size
+//     of that bucket; many students with one and the same average make it
+//     slow)
+// Students without a grade have no average and are left out.
+//
+// A bucket is floor(average() * buckets_per_unit) with average() in double,
+// the same rounding as for a query bound, so a student in a bucket strictly
+// between the buckets of low and high is inside [low, high] without looking.
+//
+// Updates take the lock exclusively (addGrades: once for the whole batch),
+// queries share it; a waiting update goes before new queries.
+class LiveGrades {
+public:
+    explicit LiveGrades(uint32_t max_grade = 600, uint32_t buckets_per_unit = 1000);
+
+    // Registers a student; the result is its number for addGrade.
+    uint32_t addStudent(std::string_view id);
+    std::optional<uint32_t> findStudent(std::string_view id) const;
+
+    void addGrade(uint32_t student, uint32_t grade);
+    void addGrades(const GradeUpdate* updates, size_t n);
+
+    size_t students() const;
+    // Students with at least one grade.
+    size_t graded() const;
+    // NaN without grades.
+    double average(uint32_t student) const;
+
+    size_t countBetween(double low, double high) const;
+    // The k best averages, best first (equal averages by student number).
+    std::vector<uint32_t> topK(size_t k) const;
+    // The student at rank ceil(p * graded()) from the lowest average (p in
+    // [0, 1]); none without grades.
+    std::optional<uint32_t> percentile(double p) const;
+
+private:
+    static const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    // One record per student: an update reads and writes one place, not four
+    // columns.
+    struct Student {
+        uint64_t sum = 0;  // hundredths
+        uint32_t count = 0;
+        uint32_t bucket = NONE;
+        uint32_t slot = 0;  // position in members[bucket]
+    };
+
+    uint32_t max_grade;
+    double scale;  // buckets per unit of average
+    size_t graded_count = 0;
+
+    std::vector<Student> records;
+    HashMap<uint64_t, uint32_t, PackedIdHash> ids;
+    std::vector<std::vector<uint32_t>> members;
+    std::vector<int32_t> tree;  // Fenwick tree, tree[1 .. buckets]
+
+    // An update first takes the gate and holds it while it waits for the
+    // queries inside to finish; new queries pass the gate, so they wait too.
+    // Without it a steady stream of queries would keep an update out for
+    // good (std::shared_mutex lets readers in while a writer waits).
+    mutable std::mutex gate;
+    mutable std::shared_mutex lock;
+
+    std::shared_lock<std::shared_mutex> readLock() const;
+
+    static double averageOf(const Student& student) { return student.sum / (100.0 * student.count); }
+    uint32_t bucketOf(double average) const;
+    void apply(uint32_t student, uint32_t grade);
+    void check(uint32_t student, uint32_t grade) const;
+
+    void treeAdd(uint32_t bucket, int32_t delta);
+    // Students in buckets [0, bucket).
+    size_t countBelow(uint32_t bucket) const;
+    // The bucket holding the student of 1-based rank; *before gets the
+    // number of students in lower buckets.
+    uint32_t bucketOfRank(size_t rank, size_t* before) const;
+    // The best `count` of members[bucket], best average first, equal ones by
+    // student number.
+    std::vector<uint32_t> bestOf(uint32_t bucket, size_t count) const;
+};
+
+inline LiveGrades::LiveGrades(uint32_t max_grade, uint32_t buckets_per_unit)
+    : max_grade(max_grade),
+      scale(buckets_per_unit),
+      members(static_cast<size_t>(max_grade) * buckets_per_unit / 100 + 1),
+      tree(members.size() + 1, 0) {
+    if (buckets_per_unit == 0) {
+        throw std::invalid_argument("At least one bucket per unit is needed");
+    }
+}
+
+inline std::shared_lock<std::shared_mutex> LiveGrades::readLock() const {
+    std::lock_guard<std::mutex> pass(gate);
+    return std::shared_lock<std::shared_mutex>(lock);
+}
+
+inline uint32_t LiveGrades::bucketOf(double average) const {
+    double bucket = std::floor(average * scale);
+    if (bucket <= 0) {
+        return 0;
+    }
+    return bucket >= members.size() - 1 ? static_cast<uint32_t>(members.size() - 1)
+                                        : static_cast<uint32_t>(bucket);
+}
+
+inline void LiveGrades::treeAdd(uint32_t bucket, int32_t delta) {
+    for (size_t i = bucket + 1; i < tree.size(); i += i & (~i + 1)) {
+        tree[i] += delta;
+    }
+}
+
+inline size_t LiveGrades::countBelow(uint32_t bucket) const {
+    size_t count = 0;
+    for (size_t i = bucket; i > 0; i &= i - 1) {
+        count += tree[i];
+    }
+    return count;
+}
+
+inline uint32_t LiveGrades::bucketOfRank(size_t rank, size_t* before) const {
+    // Descend from the highest power of two: position ends on the last
+    // prefix with fewer than rank students.
+    size_t position = 0;
+    size_t step = 1;
+    while (step * 2 < tree.size()) {
+        step *= 2;
+    }
+    *before = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step < tree.size() && *before + tree[position + step] < rank) {
+            position += step;
+            *before += tree[position];
+        }
+    }
+    return static_cast<uint32_t>(position);
+}
+
+inline std::vector<uint32_t> LiveGrades::bestOf(uint32_t bucket, size_t count) const {
+    std::vector<uint32_t> students = members[bucket];
+    count = std::min(count, students.size());
+    std::partial_sort(students.begin(), students.begin() + count, students.end(), [this](uint32_t a, uint32_t b) {
+        double x = averageOf(records[a]), y = averageOf(records[b]);
+        return x > y || (x == y && a < b);
+    });
+    students.resize(count);
+    return students;
+}
+
+inline uint32_t LiveGrades::addStudent(std::string_view id) {
+    uint64_t key;
+    if (!packId(id, key)) {
+        throw std::invalid_argument("Bad student ID '" + std::string(id) + "'");
+    }
+    std::lock_guard<std::mutex> pass(gate);
+    std::unique_lock<std::shared_mutex> guard(lock);
+    if (ids.get(key) != ids.cend()) {
+        throw std::invalid_argument("Student " + std::string(id) + " already exists");
+    }
+    if (records.size() == NONE) {
+        throw std::length_error("Too many students");
+    }
+    ids.add(key, static_cast<uint32_t>(records.size()));
+    records.emplace_back();
+    return static_cast<uint32_t>(records.size() - 1);
+}
+
+inline std::optional<uint32_t> LiveGrades::findStudent(std::string_view id) const {
+    uint64_t key;
+    if (!packId(id, key)) {
+        return std::nullopt;
+    }
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    auto found = ids.get(key);
+    if (found == ids.cend()) {
+        return std::nullopt;
+    }
+    return (*found).second;
+}
+
+inline void LiveGrades::check(uint32_t student, uint32_t grade) const {
+    if (student >= records.size()) {
+        throw std::out_of_range("No student " + std::to_string(student));
+    }
+    if (grade > max_grade) {
+        throw std::invalid_argument("Grade " + std::to_string(grade) + " is above the maximum");
+    }
+    if (records[student].count == std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many grades for one student");
+    }
+}
+
+inline void LiveGrades::apply(uint32_t student, uint32_t grade) {
+    Student& record = records[student];
+    record.sum += grade;
+    record.count++;
+    uint32_t bucket = bucketOf(averageOf(record));
+    if (bucket == record.bucket) {
+        return;
+    }
+    if (record.bucket == NONE) {
+        graded_count++;
+    } else {
+        // Swap-remove from the old bucket.
+        std::vector<uint32_t>& old = members[record.bucket];
+        uint32_t last = old.back();
+        old[record.slot] = last;
+        records[last].slot = record.slot;
+        old.pop_back();
+        treeAdd(record.bucket, -1);
+    }
+    record.bucket = bucket;
+    record.slot = static_cast<uint32_t>(members[bucket].size());
+    members[bucket].push_back(student);
+    treeAdd(bucket, 1);
+}
+
+inline void LiveGrades::addGrade(uint32_t student, uint32_t grade) {
+    std::lock_guard<std::mutex> pass(gate);
+    std::unique_lock<std::shared_mutex> guard(lock);
+    check(student, grade);
+    apply(student, grade);
+}
+
+inline void LiveGrades::addGrades(const GradeUpdate* updates, size_t n) {
+    std::lock_guard<std::mutex> pass(gate);
+    std::unique_lock<std::shared_mutex> guard(lock);
+    // All or nothing. (Counts only overflow after 4G grades each; checked
+    // against the count before the batch.)
+    for (size_t i = 0; i < n; ++i) {
+        check(updates[i].student, updates[i].grade);
+    }
+    const size_t AHEAD = 16;
+    for (size_t i = 0; i < n; ++i) {
+        if (i + AHEAD < n) {
+            // The records are spread over memory; start the next misses now.
+            __builtin_prefetch(&records[updates[i + AHEAD].student]);
+        }
+        apply(updates[i].student, updates[i].grade);
+    }
+}
+
+inline size_t LiveGrades::students() const {
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    return records.size();
+}
+
+inline size_t LiveGrades::graded() const {
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    return graded_count;
+}
+
+inline double LiveGrades::average(uint32_t student) const {
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    if (student >= records.size()) {
+        throw std::out_of_range("No student " + std::to_string(student));
+    }
+    return averageOf(records[student]);
+}
+
+inline size_t LiveGrades::countBetween(double low, double high) const {
+    if (!(low <= high)) {
+        return 0;
+    }
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    auto inside = [&](uint32_t bucket) {
+        return static_cast<size_t>(std::count_if(members[bucket].begin(), members[bucket].end(), [&](uint32_t s) {
+            double average = averageOf(records[s]);
+            return low <= average && average <= high;
+        }));
+    };
+    uint32_t first = bucketOf(low);
+    uint32_t last = bucketOf(high);
+    if (first == last) {
+        return inside(first);
+    }
+    return inside(first) + countBelow(last) - countBelow(first + 1) + inside(last);
+}
+
+inline std::vector<uint32_t> LiveGrades::topK(size_t k) const {
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    k = std::min(k, graded_count);
+    std::vector<uint32_t> best;
+    if (k == 0) {
+        return best;
+    }
+    // The k-th best is the student of rank graded - k + 1 from below.
+    size_t before;
+    uint32_t boundary = bucketOfRank(graded_count - k + 1, &before);
+    best.reserve(k);
+    for (uint32_t bucket = static_cast<uint32_t>(members.size() - 1); bucket > boundary; --bucket) {
+        std::vector<uint32_t> students = bestOf(bucket, members[bucket].size());
+        best.insert(best.end(), students.begin(), students.end());
+    }
+    std::vector<uint32_t> students = bestOf(boundary, k - best.size());
+    best.insert(best.end(), students.begin(), students.end());
+    return best;
+}
+
+inline std::optional<uint32_t> LiveGrades::percentile(double p) const {
+    if (!(p >= 0 && p <= 1)) {
+        throw std::invalid_argument("A percentile is between 0 and 1");
+    }
+    std::shared_lock<std::shared_mutex> guard = readLock();
+    if (graded_count == 0) {
+        return std::nullopt;
+    }
+    size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(p * graded_count)));
+    size_t before;
+    uint32_t bucket = bucketOfRank(rank, &before);
+    std::vector<uint32_t> students = members[bucket];
+    auto nth = students.begin() + (rank - before - 1);
+    std::nth_element(students.begin(), nth, students.end(), [this](uint32_t a, uint32_t b) {
+        double x = averageOf(records[a]), y = averageOf(records[b]);
+        return x < y || (x == y && a < b);
+    });
+    return *nth;
+}
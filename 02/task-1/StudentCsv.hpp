@@ -0,0 +1,380 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "../../07_hash/LinearProbingHash/map/HashMap.hpp"
+
+// Reading student_id,name,grade files without copying them.
+//
+// The file is mapped into memory and every field is a std::string_view
+// into the mapping; a grade is parsed straight into hundredths. Row and
+// field boundaries come from one pass over 64-byte blocks that marks every
+// ',' and '\n' in a bit mask (two AVX2 compares per 32 bytes), so the
+// parser only visits the separators.
+//
+// averageGrades splits the file into one piece per thread at line
+// boundaries. Every thread sums the grades of its piece per student in its
+// own table; the tables are merged at the end.
+//
+// Quoted fields are not supported (no comma inside a name).
+
+// Parses "5", "5.5" or "5.50" into hundredths.
+inline bool parseHundredths(const char* begin, const char* end, uint32_t& hundredths) {
+    hundredths = 0;
+    const char* p = begin;
+    for (; p < end && *p >= '0' && *p <= '9' && p - begin < 4; ++p) {
+        hundredths = hundredths * 10 + (*p - '0');
+    }
+    bool valid = p > begin;
+    hundredths *= 100;
+    if (valid && p < end && *p == '.') {
+        const char* fraction = ++p;
+        for (uint32_t scale = 10; p < end && *p >= '0' && *p <= '9' && p - fraction < 2; ++p, scale /= 10) {
+            hundredths += (*p - '0') * scale;
+        }
+        valid = p > fraction;
+    }
+    return valid && p == end;
+}
+
+// Student IDs of up to 12 characters 0-9 / A-Z as base-37 numbers, one
+// digit per character (0 is no character, so "01" and "1" differ).
+inline bool packId(std::string_view id, uint64_t& key) {
+    if (id.empty() || id.size() > 12) {
+        return false;
+    }
+    key = 0;
+    for (char c : id) {
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = 1 + (c - '0');
+        } else if (c >= 'A' && c <= 'Z') {
+            digit = 11 + (c - 'A');
+        } else {
+            return false;
+        }
+        key = key * 37 + digit;
+    }
+    return true;
+}
+
+struct PackedIdHash {
+    size_t operator()(uint64_t key) const {
+        // Packed IDs are nearly consecutive; mix all bits into the low ones
+        // a table takes its index from.
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+};
+
+// A read-only mapping of a whole file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+};
+
+inline MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("Cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::invalid_argument("Cannot stat " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::invalid_argument("Cannot map " + path);
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(mapped);
+    }
+    close(fd);  // the mapping stays
+}
+
+inline MappedFile::~MappedFile() {
+    if (bytes) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+}
+
+struct CsvRow {
+    std::string_view id;
+    std::string_view name;
+    uint32_t grade;   // hundredths
+    uint64_t offset;  // of the row in the file
+};
+
+namespace csv_blocks {
+
+const size_t BLOCK = 64;
+
+#ifdef __AVX2__
+inline uint64_t separatorsOf(__m256i bytes) {
+    __m256i comma = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(','));
+    __m256i newline = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(comma, newline)));
+}
+#endif
+
+// Bit i is set when block[i] is ',' or '\n'.
+inline uint64_t separators(const char* block) {
+#ifdef __AVX2__
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return separatorsOf(lo) | separatorsOf(hi) << 32;
+#else
+    // 8 bytes at a time: a byte of x is zero exactly where the word matched,
+    // the high bit of every byte then says "matched" and the multiply
+    // gathers the 8 high bits into one byte.
+    const uint64_t LOW_7 = 0x7f7f7f7f7f7f7f7fULL;
+    const uint64_t GATHER = 0x0102040810204080ULL;
+    auto zeroBytes = [&](uint64_t x) { return ~(((x & LOW_7) + LOW_7) | x | LOW_7); };
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, block + i, 8);
+        uint64_t found = zeroBytes(word ^ 0x2c2c2c2c2c2c2c2cULL) | zeroBytes(word ^ 0x0a0a0a0a0a0a0a0aULL);
+        mask |= ((found >> 7) * GATHER >> 56) << i;
+    }
+    return mask;
+#endif
+}
+
+}  // namespace csv_blocks
+
+// Calls visit(row) for every row of data[0, n); `offset` is where data
+// starts in the file, for the error messages. Blank lines are skipped, a
+// '\r' before '\n' is dropped and the last row needs no '\n'.
+template <typename Visit>
+void forEachRow(const char* data, size_t n, uint64_t offset, Visit visit) {
+    using namespace csv_blocks;
+    const char* row = data;  // start of the current row
+    const char* commas[2];    // its first two commas
+    int fields = 0;           // commas seen in it
+
+    auto fail = [&](const char* at, const std::string& what) {
+        throw std::invalid_argument("Byte " + std::to_string(offset + (at - data)) + ": " + what);
+    };
+    auto finish = [&](const char* end) {
+        if (end > row && end[-1] == '\r') {
+            end--;
+        }
+        if (end == row && fields == 0) {
+            return;
+        }
+        if (fields != 2) {
+            fail(row, "expected student_id,name,grade");
+        }
+        CsvRow parsed{std::string_view(row, commas[0] - row),
+                      std::string_view(commas[0] + 1, commas[1] - commas[0] - 1), 0,
+                      offset + (row - data)};
+        if (!parseHundredths(commas[1] + 1, end, parsed.grade)) {
+            fail(commas[1] + 1, "bad grade '" + std::string(commas[1] + 1, end) + "'");
+        }
+        visit(parsed);
+    };
+
+    char padded[BLOCK];
+    for (size_t start = 0; start < n; start += BLOCK) {
+        const char* block = data + start;
+        uint64_t mask;
+        if (n - start >= BLOCK) {
+            mask = separators(block);
+        } else {
+            // Never read past the end of the mapping.
+            std::memset(padded, 0, BLOCK);
+            std::memcpy(padded, block, n - start);
+            mask = separators(padded);
+        }
+        while (mask) {
+            const char* at = block + __builtin_ctzll(mask);
+            mask &= mask - 1;
+            if (*at == ',') {
+                if (fields == 2) {
+                    fail(at, "too many fields");
+                }
+                commas[fields++] = at;
+            } else {
+                finish(at);
+                row = at + 1;
+                fields = 0;
+            }
+        }
+    }
+    finish(data + n);
+}
+
+// Grade sum of one student.
+struct StudentTotal {
+    std::string_view id;
+    std::string_view name;  // from the student's first row
+    uint64_t grade_sum;     // hundredths
+    uint32_t grade_count;
+
+    double average() const { return grade_sum / (100.0 * grade_count); }
+};
+
+// Per student totals, in order of first appearance.
+//
+// Keyed by the packed ID; nothing compares strings or goes back to the
+// text of a student's first row. Rows are looked up BATCH at a time, after
+// they are parsed: interleaved with the parsing every lookup waits for its
+// cache miss alone, in a loop of only lookups the misses overlap.
+class GradeTotals {
+public:
+    static const size_t BATCH = 256;
+
+    void add(const CsvRow& row);
+    // Looks up the rows still waiting in the batch.
+    void flush();
+    // Adds the totals of the rows after the ones seen so far.
+    void merge(GradeTotals& next);
+
+    std::vector<StudentTotal> totals();
+
+private:
+    struct Sum {
+        uint64_t grades;
+        uint64_t count;
+    };
+
+    HashMap<uint64_t, uint32_t, PackedIdHash> index;  // packed id -> student
+    std::vector<Sum> sums;
+    std::vector<uint64_t> keys;
+    std::vector<CsvRow> first_rows;
+
+    CsvRow batch[BATCH];
+    uint64_t batch_keys[BATCH];
+    size_t batched = 0;
+
+    Sum& find(uint64_t key, const CsvRow& row);
+};
+
+inline GradeTotals::Sum& GradeTotals::find(uint64_t key, const CsvRow& row) {
+    auto found = index.get(key);
+    if (found != index.cend()) {
+        return sums[(*found).second];
+    }
+    index.add(key, static_cast<uint32_t>(sums.size()));
+    sums.push_back({0, 0});
+    keys.push_back(key);
+    first_rows.push_back(row);
+    return sums.back();
+}
+
+inline void GradeTotals::add(const CsvRow& row) {
+    if (!packId(row.id, batch_keys[batched])) {
+        throw std::invalid_argument("Byte " + std::to_string(row.offset) + ": bad student ID '" +
+                                    std::string(row.id) + "'");
+    }
+    batch[batched++] = row;
+    if (batched == BATCH) {
+        flush();
+    }
+}
+
+inline void GradeTotals::flush() {
+    for (size_t i = 0; i < batched; ++i) {
+        Sum& sum = find(batch_keys[i], batch[i]);
+        sum.grades += batch[i].grade;
+        sum.count++;
+    }
+    batched = 0;
+}
+
+inline void GradeTotals::merge(GradeTotals& next) {
+    flush();
+    next.flush();
+    for (size_t i = 0; i < next.sums.size(); ++i) {
+        Sum& sum = find(next.keys[i], next.first_rows[i]);
+        sum.grades += next.sums[i].grades;
+        sum.count += next.sums[i].count;
+    }
+}
+
+inline std::vector<StudentTotal> GradeTotals::totals() {
+    flush();
+    std::vector<StudentTotal> students;
+    students.reserve(sums.size());
+    for (size_t i = 0; i < sums.size(); ++i) {
+        students.push_back(
+            {first_rows[i].id, first_rows[i].name, sums[i].grades, static_cast<uint32_t>(sums[i].count)});
+    }
+    return students;
+}
+
+// The totals of every student in data[0, n), counted on `threads` threads.
+// The string_views point into data.
+inline std::vector<StudentTotal> averageGrades(const char* data, size_t n, unsigned threads) {
+    threads = std::max(1u, threads);
+    // Piece t starts after the first '\n' at or past t * n / threads.
+    std::vector<size_t> bounds(threads + 1, n);
+    bounds[0] = 0;
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t at = std::max(bounds[t - 1], n / threads * t);
+        const void* newline = at < n ? std::memchr(data + at, '\n', n - at) : nullptr;
+        bounds[t] = newline ? static_cast<const char*>(newline) - data + 1 : n;
+    }
+
+    std::vector<GradeTotals> totals(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            try {
+                forEachRow(data + bounds[t], bounds[t + 1] - bounds[t], bounds[t],
+                           [&](const CsvRow& row) { totals[t].add(row); });
+                totals[t].flush();
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);  // the first one in the file
+        }
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        totals[0].merge(totals[t]);
+    }
+    return totals[0].totals();
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../07_hash/LinearProbingHash/map/HashMap.hpp"
+#include "../../07_hash/StringPool/StringPool.hpp"
+#include "StudentCsv.hpp"
+
+// The students of students.csv (student_id,name,grade), loaded once and then
+// only searched: by ID, by name or name prefix and by average grade.
+//
+// A student may have several rows (one per grade); they are merged into one
+// student whose average is the mean of the grades. Students are numbered
+// 0 .. size()-1 in order of their first row and every column is a plain
+// array over that number:
+//   - ids: the ID packed into a uint64_t (see packId in StudentCsv.hpp)
+//   - names: code of the name in a dictionary of the distinct names, which
+//     are stored back to back in one string
+//   - grade sums (in hundredths) and grade counts
+//
+// Indexes, all built once at the end of loading:
+//   - ID -> student: HashMap from 07_hash, sized up front so it never grows
+//   - name: the distinct names are sorted and their codes renumbered in that
+//     order, so the students sorted by name code are sorted by name and the
+//     students of any range of names - an exact name, a prefix - are one
+//     contiguous piece of that array: two binary searches over the distinct
+//     names, no per-student work
+//   - average: the students sorted by average, with the averages as floats
+//     beside them for the binary search (the exact double decides only at the
+//     two ends of a range)
+//
+// Names are compared byte by byte (UTF-8 order, not Bulgarian collation).
+// Quoted CSV fields are not supported.
+class StudentStore {
+public:
+    // Students found by a query: a piece of one of the indexes.
+    struct Matches {
+        const uint32_t* first = nullptr;
+        const uint32_t* last = nullptr;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    // expected_rows only sizes the columns and the hash table up front.
+    explicit StudentStore(std::istream& csv, size_t expected_rows = 0);
+
+    // Estimates the number of rows from the file size and its first lines.
+    static StudentStore fromFile(const std::string& path);
+
+    std::optional<uint32_t> findById(std::string_view id) const;
+    // In order of student number.
+    Matches findByName(std::string_view name) const;
+    // By name, then by student number.
+    Matches findByNamePrefix(std::string_view prefix) const;
+    // All students with low <= average <= high, lowest average first.
+    Matches findByAverage(double low, double high) const;
+
+    std::string id(uint32_t student) const;
+    std::string_view name(uint32_t student) const;
+    double average(uint32_t student) const;
+    size_t gradeCount(uint32_t student) const { return grade_counts[student]; }
+
+    size_t size() const { return ids.size(); }
+    size_t distinctNames() const { return name_offsets.size() - 1; }
+
+private:
+    static const size_t BLOCK = 1 << 20;  // bytes per read()
+
+    std::vector<uint64_t> ids;
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> grade_sums;
+    std::vector<uint16_t> grade_counts;
+
+    HashMap<uint64_t, uint32_t, PackedIdHash> id_index;
+
+    std::string name_chars;             // distinct names, sorted, back to back
+    std::vector<uint32_t> name_offsets;  // name c is [offsets[c], offsets[c + 1])
+    std::vector<uint32_t> name_begin;    // students of name c: by_name[begin[c], begin[c + 1])
+    std::vector<uint32_t> by_name;
+    std::vector<uint32_t> by_average;
+    std::vector<float> average_keys;     // float(average(by_average[i]))
+
+    static size_t tableSize(size_t expected_rows);
+    static uint32_t parseGrade(const char* begin, const char* end, size_t line_number);
+
+    void addRow(const char* line, const char* end, size_t line_number, StringPool& dictionary);
+    void buildNameIndex(const StringPool& dictionary);
+    void buildAverageIndex();
+    std::string_view distinctName(uint32_t code) const;
+    uint32_t firstNameNotBelow(std::string_view name) const;
+    Matches studentsNamed(uint32_t first_code, uint32_t last_code) const;
+};
+
+inline size_t StudentStore::tableSize(size_t expected_rows) {
+    // The HashMap doubles once more than 80% full; stay below that. It
+    // probes in steps of 3, so the size must not be a multiple of 3 or a
+    // probe sees a third of the buckets (and doubling keeps it so).
+    size_t size = expected_rows == 0 ? 10 : expected_rows / 4 * 5 + 16;
+    return size % 3 == 0 ? size + 1 : size;
+}
+
+inline uint32_t StudentStore::parseGrade(const char* begin, const char* end, size_t line_number) {
+    // Kept in hundredths so sums are exact.
+    uint32_t hundredths;
+    if (!parseHundredths(begin, end, hundredths)) {
+        throw std::invalid_argument("Line " + std::to_string(line_number) + ": bad grade '" +
+                                    std::string(begin, end) + "'");
+    }
+    return hundredths;
+}
+
+inline StudentStore::StudentStore(std::istream& csv, size_t expected_rows) : id_index(tableSize(expected_rows)) {
+    ids.reserve(expected_rows);
+    names.reserve(expected_rows);
+    grade_sums.reserve(expected_rows);
+    grade_counts.reserve(expected_rows);
+
+    StringPool dictionary;  // the distinct names, in order of first appearance
+    std::string buffer(BLOCK, '\0');
+    size_t kept = 0;  // start of an unfinished line at the front of buffer
+    size_t line_number = 0;
+    while (true) {
+        csv.read(&buffer[kept], static_cast<std::streamsize>(buffer.size() - kept));
+        size_t filled = kept + static_cast<size_t>(csv.gcount());
+        if (filled == kept) {
+            if (kept > 0) {
+                addRow(buffer.data(), buffer.data() + kept, ++line_number, dictionary);  // no final '\n'
+            }
+            break;
+        }
+        const char* line = buffer.data();
+        const char* end = buffer.data() + filled;
+        while (const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line))) {
+            addRow(line, newline, ++line_number, dictionary);
+            line = newline + 1;
+        }
+        kept = static_cast<size_t>(end - line);
+        std::memmove(&buffer[0], line, kept);
+        if (kept == buffer.size()) {
+            buffer.resize(2 * buffer.size());  // a line longer than the buffer
+        }
+    }
+
+    buildNameIndex(dictionary);
+    buildAverageIndex();
+}
+
+inline StudentStore StudentStore::fromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::invalid_argument("Cannot open " + path);
+    }
+    file.seekg(0, std::ios::end);
+    size_t bytes = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    std::string sample(std::min<size_t>(bytes, 1 << 16), '\0');
+    file.read(&sample[0], static_cast<std::streamsize>(sample.size()));
+    size_t lines = static_cast<size_t>(std::count(sample.begin(), sample.end(), '\n'));
+    file.seekg(0);
+
+    size_t expected = lines == 0 ? 0 : static_cast<size_t>(bytes / (double(sample.size()) / lines) * 1.05);
+    return StudentStore(file, expected);
+}
+
+inline void StudentStore::addRow(const char* line, const char* end, size_t line_number,
+                                 StringPool& dictionary) {
+    if (end > line && end[-1] == '\r') {
+        end--;
+    }
+    if (line == end) {
+        return;
+    }
+    const char* first = static_cast<const char*>(std::memchr(line, ',', end - line));
+    const char* second = first ? static_cast<const char*>(std::memchr(first + 1, ',', end - first - 1)) : nullptr;
+    if (!second) {
+        throw std::invalid_argument("Line " + std::to_string(line_number) + ": expected student_id,name,grade");
+    }
+    uint64_t key;
+    if (!packId(std::string_view(line, first - line), key)) {
+        throw std::invalid_argument("Line " + std::to_string(line_number) + ": bad student ID '" +
+                                    std::string(line, first) + "'");
+    }
+    uint32_t grade = parseGrade(second + 1, end, line_number);
+    uint32_t code = dictionary.intern(std::string_view(first + 1, second - first - 1));
+
+    auto found = id_index.get(key);
+    if (found != id_index.cend()) {
+        uint32_t student = (*found).second;
+        if (names[student] != code) {
+            throw std::invalid_argument("Line " + std::to_string(line_number) + ": student " +
+                                        std::string(line, first) + " has a different name before");
+        }
+        if (grade_counts[student] == std::numeric_limits<uint16_t>::max()) {
+            throw std::length_error("Too many grades for one student");
+        }
+        grade_sums[student] += grade;
+        grade_counts[student]++;
+        return;
+    }
+    if (ids.size() == std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many students");
+    }
+    id_index.add(key, static_cast<uint32_t>(ids.size()));
+    ids.push_back(key);
+    names.push_back(code);
+    grade_sums.push_back(grade);
+    grade_counts.push_back(1);
+}
+
+inline void StudentStore::buildNameIndex(const StringPool& dictionary) {
+    // The pool's handles are the codes, in order of first appearance.
+    size_t distinct = dictionary.getSize();
+    std::vector<uint32_t> order(distinct);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return dictionary.view(a) < dictionary.view(b); });
+
+    std::vector<uint32_t> rank(distinct);
+    name_offsets.assign(1, 0);
+    for (uint32_t r = 0; r < distinct; ++r) {
+        rank[order[r]] = r;
+        name_chars += dictionary.view(order[r]);
+        name_offsets.push_back(static_cast<uint32_t>(name_chars.size()));
+    }
+
+    // Counting sort of the students by their new code.
+    name_begin.assign(distinct + 1, 0);
+    for (uint32_t& code : names) {
+        code = rank[code];
+        name_begin[code + 1]++;
+    }
+    std::partial_sum(name_begin.begin(), name_begin.end(), name_begin.begin());
+    by_name.resize(names.size());
+    std::vector<uint32_t> next(name_begin.begin(), name_begin.end() - 1);
+    for (uint32_t student = 0; student < names.size(); ++student) {
+        by_name[next[names[student]]++] = student;
+    }
+}
+
+inline void StudentStore::buildAverageIndex() {
+    size_t n = ids.size();
+    // (float bits << 32 | student): the bits of a non-negative float order
+    // like the float, and the students are already in order, so a stable
+    // sort on the upper half - two counting passes of 16 bits - is enough.
+    std::vector<uint64_t> keyed(n);
+    std::vector<uint64_t> sorted(n);
+    for (uint32_t student = 0; student < n; ++student) {
+        float key = static_cast<float>(average(student));
+        uint32_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        keyed[student] = uint64_t(bits) << 32 | student;
+    }
+    for (int shift : {32, 48}) {
+        std::vector<size_t> start(1 << 16 | 1, 0);
+        for (uint64_t value : keyed) {
+            start[(value >> shift & 0xffff) + 1]++;
+        }
+        std::partial_sum(start.begin(), start.end(), start.begin());
+        for (uint64_t value : keyed) {
+            sorted[start[value >> shift & 0xffff]++] = value;
+        }
+        keyed.swap(sorted);
+    }
+    sorted = std::vector<uint64_t>();
+
+    by_average.resize(n);
+    average_keys.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        by_average[i] = static_cast<uint32_t>(keyed[i]);
+        uint32_t bits = static_cast<uint32_t>(keyed[i] >> 32);
+        std::memcpy(&average_keys[i], &bits, sizeof(bits));
+    }
+    // Different averages can round to the same float; order those runs by
+    // the exact average (rounding keeps order, so nothing else moves).
+    auto exact = [this](uint32_t a, uint32_t b) {
+        double x = average(a), y = average(b);
+        return x < y || (x == y && a < b);
+    };
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && average_keys[j] == average_keys[i]) {
+            j++;
+        }
+        if (!std::is_sorted(by_average.begin() + i, by_average.begin() + j, exact)) {
+            std::sort(by_average.begin() + i, by_average.begin() + j, exact);
+        }
+        i = j;
+    }
+}
+
+inline std::string_view StudentStore::distinctName(uint32_t code) const {
+    return std::string_view(name_chars).substr(name_offsets[code], name_offsets[code + 1] - name_offsets[code]);
+}
+
+inline std::optional<uint32_t> StudentStore::findById(std::string_view id) const {
+    uint64_t key;
+    if (!packId(id, key)) {
+        return std::nullopt;
+    }
+    auto found = id_index.get(key);
+    if (found == id_index.cend()) {
+        return std::nullopt;
+    }
+    return (*found).second;
+}
+
+inline uint32_t StudentStore::firstNameNotBelow(std::string_view name) const {
+    uint32_t low = 0, high = static_cast<uint32_t>(distinctNames());
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (distinctName(middle) < name) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+inline StudentStore::Matches StudentStore::studentsNamed(uint32_t first_code, uint32_t last_code) const {
+    return {by_name.data() + name_begin[first_code], by_name.data() + name_begin[last_code]};
+}
+
+inline StudentStore::Matches StudentStore::findByName(std::string_view name) const {
+    uint32_t code = firstNameNotBelow(name);
+    if (code == distinctNames() || distinctName(code) != name) {
+        return {};
+    }
+    return studentsNamed(code, code + 1);
+}
+
+inline StudentStore::Matches StudentStore::findByNamePrefix(std::string_view prefix) const {
+    // The names starting with prefix follow the first name >= prefix.
+    uint32_t low = firstNameNotBelow(prefix);
+    uint32_t high = static_cast<uint32_t>(distinctNames());
+    for (uint32_t begin = low; begin < high;) {
+        uint32_t middle = begin + (high - begin) / 2;
+        if (distinctName(middle).substr(0, prefix.size()) == prefix) {
+            begin = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return studentsNamed(low, high);
+}
+
+inline StudentStore::Matches StudentStore::findByAverage(double low, double high) const {
+    if (!(low <= high)) {
+        return {};
+    }
+    // Rounding to float keeps order: every average >= low has a key >=
+    // float(low), every key > float(low) belongs to an average > low. Only
+    // the keys equal to float(low) (or float(high)) need the exact average.
+    auto keys = average_keys.begin();
+    auto pieceOf = [&](float key) {
+        auto range = std::equal_range(keys, average_keys.end(), key);
+        return std::make_pair(by_average.begin() + (range.first - keys), by_average.begin() + (range.second - keys));
+    };
+    auto lowPiece = pieceOf(static_cast<float>(low));
+    auto first = std::partition_point(lowPiece.first, lowPiece.second,
+                                      [&](uint32_t student) { return average(student) < low; });
+    auto highPiece = pieceOf(static_cast<float>(high));
+    auto last = std::partition_point(highPiece.first, highPiece.second,
+                                     [&](uint32_t student) { return average(student) <= high; });
+    return {by_average.data() + (first - by_average.begin()), by_average.data() + (last - by_average.begin())};
+}
+
+inline std::string StudentStore::id(uint32_t student) const {
+    char digits[12];
+    size_t n = 0;
+    for (uint64_t key = ids[student]; key > 0; key /= 37) {
+        uint64_t digit = key % 37;
+        digits[n++] = static_cast<char>(digit <= 10 ? '0' + (digit - 1) : 'A' + (digit - 11));
+    }
+    return std::string(std::make_reverse_iterator(digits + n), std::make_reverse_iterator(digits));
+}
+
+inline std::string_view StudentStore::name(uint32_t student) const {
+    return distinctName(names[student]);
+}
+
+inline double StudentStore::average(uint32_t student) const {
+    return grade_sums[student] / (100.0 * grade_counts[student]);
+}
@@ -0,0 +1,131 @@
+// g++ -O2 -std=c++17 -pthread live_grades.cpp -o live_grades
+//
+//   ./live_grades [students] [updates] [query threads]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LiveGrades.hpp"
+using namespace std;
+
+const size_t BATCH = 4096;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Feeds `total` updates, BATCH at a time, cycling through `stream`.
+double feed(LiveGrades& grades, const vector<GradeUpdate>& stream, size_t total) {
+    auto start = chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += BATCH) {
+        size_t at = done % stream.size();
+        grades.addGrades(stream.data() + at, min({BATCH, total - done, stream.size() - at}));
+    }
+    return secondsSince(start);
+}
+
+struct QueryStats {
+    size_t count[3] = {};
+    double seconds[3] = {};
+};
+
+// Round robin of the three kinds of query until `stop`.
+void query(const LiveGrades& grades, const atomic<bool>& stop, QueryStats& stats) {
+    size_t sink = 0;
+    for (size_t i = 0; !stop.load(memory_order_relaxed); ++i) {
+        auto start = chrono::steady_clock::now();
+        switch (i % 3) {
+            case 0:
+                sink += grades.countBetween(4.50, 5.00);
+                break;
+            case 1:
+                sink += grades.topK(10).size();
+                break;
+            default:
+                sink += grades.percentile(0.9).value_or(0);
+                break;
+        }
+        stats.seconds[i % 3] += secondsSince(start);
+        stats.count[i % 3]++;
+    }
+    if (sink == 1) {
+        cout << "";
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t students = argc > 1 ? stoull(argv[1]) : 1000000;
+    size_t updates = argc > 2 ? stoull(argv[2]) : 50000000;
+    unsigned readers = argc > 3 ? static_cast<unsigned>(stoul(argv[3])) : 2;
+
+    LiveGrades grades;
+    auto start = chrono::steady_clock::now();
+    for (size_t s = 0; s < students; ++s) {
+        uint64_t number = s * 48271 % 100000000;
+        char id[16];
+        snprintf(id, sizeof(id), "%lluMI%07llu", (unsigned long long)(number / 10000000),
+                 (unsigned long long)(number % 10000000));
+        grades.addStudent(id);
+    }
+    cout << students << " students registered in " << secondsSince(start) << " s, "
+         << thread::hardware_concurrency() << " hardware threads\n";
+
+    // A grade of 2.00 .. 6.00 for a random student.
+    mt19937_64 rng(49);
+    vector<GradeUpdate> stream(min<size_t>(updates, 16 * 1000000));
+    for (GradeUpdate& update : stream) {
+        uint64_t r = rng();
+        update = {static_cast<uint32_t>((r >> 8) % students), static_cast<uint32_t>(200 + r % 401)};
+    }
+
+    // Grade everyone once so the queries have data.
+    feed(grades, stream, min(stream.size(), students * 4));
+    double seconds = feed(grades, stream, updates);
+    cout << "  updates alone                " << updates / seconds / 1e6 << " M updates/s\n";
+
+    atomic<bool> stop(false);
+    vector<QueryStats> stats(readers);
+    vector<thread> workers;
+    for (unsigned t = 0; t < readers; ++t) {
+        workers.emplace_back(query, cref(grades), cref(stop), ref(stats[t]));
+    }
+    seconds = feed(grades, stream, updates);
+    stop = true;
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    cout << "  updates with " << readers << " query threads  " << updates / seconds / 1e6 << " M updates/s\n";
+    const char* names[] = {"countBetween(4.50, 5.00)", "topK(10)                ", "percentile(0.9)         "};
+    for (int kind = 0; kind < 3; ++kind) {
+        size_t count = 0;
+        double total = 0;
+        for (const QueryStats& s : stats) {
+            count += s.count[kind];
+            total += s.seconds[kind];
+        }
+        cout << "    " << names[kind] << "  " << count / seconds << " queries/s, " << total / max<size_t>(count, 1) * 1e6
+             << " us/query (waiting for the lock included)\n";
+    }
+
+    // Without the buckets: the 90th percentile needs a pass over everyone.
+    vector<pair<double, uint32_t>> all;
+    start = chrono::steady_clock::now();
+    for (uint32_t s = 0; s < students; ++s) {
+        double average = grades.average(s);
+        if (average == average) {  // graded
+            all.push_back({average, s});
+        }
+    }
+    size_t rank = (all.size() * 9 + 9) / 10;  // ceil(0.9 * graded)
+    nth_element(all.begin(), all.begin() + static_cast<ptrdiff_t>(rank - 1), all.end());
+    cout << "  percentile(0.9) by nth_element over all averages: " << secondsSince(start) * 1e6 << " us (student "
+         << all[rank - 1].second << ", buckets say " << grades.percentile(0.9).value_or(0) << ")\n";
+    return 0;
+}
@@ -0,0 +1,147 @@
+// g++ -O2 -std=c++17 -mavx2 -pthread student_csv.cpp -o student_csv
+//
+//   ./student_csv [gigabytes] [csv file]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "StudentCsv.hpp"
+using namespace std;
+
+const size_t STUDENTS = 200000;
+
+const char* FIRST[] = {"Александър", "Мария", "Георги", "Елена", "Иван", "Христина", "Николай", "Петя",
+                       "Стоян", "Виктория", "Димитър", "Радослава", "Любомир", "Теодора", "Красимир", "Гергана"};
+const char* LAST[] = {"Петров", "Иванов", "Димитров", "Георгиев", "Николов", "Стоянов", "Василев", "Атанасов",
+                      "Тодоров", "Костов", "Христов", "Маринов", "Симеонов", "Колев", "Йорданов", "Ангелов"};
+
+// One grade per row for STUDENTS students, until the file has `bytes` bytes.
+void writeGrades(const string& path, uint64_t bytes) {
+    vector<string> prefixes(STUDENTS);  // "id,name,"
+    for (size_t s = 0; s < STUDENTS; ++s) {
+        uint64_t number = s * 48271 % 100000000;
+        char id[16];
+        snprintf(id, sizeof(id), "%lluMI%07llu", (unsigned long long)(number / 10000000),
+                 (unsigned long long)(number % 10000000));
+        bool female = s % 2;
+        prefixes[s] = string(id) + "," + FIRST[s / 2 % 8 * 2 + female] + " " + LAST[s / 16 % 16] +
+                      (female ? "а" : "") + ",";
+    }
+    ofstream out(path, ios::binary);
+    mt19937_64 rng(48);
+    string buffer;
+    for (uint64_t written = 0; written < bytes;) {
+        uint64_t r = rng();
+        unsigned quarters = 8 + static_cast<unsigned>(r % 17);  // 2.00 .. 6.00
+        buffer += prefixes[(r >> 8) % STUDENTS];
+        buffer += static_cast<char>('0' + quarters / 4);
+        buffer += '.';
+        buffer += "0257"[quarters % 4];
+        buffer += "0050"[quarters % 4];
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) {
+            out << buffer;
+            written += buffer.size();
+            buffer.clear();
+        }
+    }
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// The line-by-line way: getline, split the line, stod the grade, one
+// std::string key per row. Stops after `limit` bytes.
+using GetlineTotals = unordered_map<string, pair<double, unsigned>>;
+
+void getlineAverages(const string& path, uint64_t limit, uint64_t& bytes, GetlineTotals& totals) {
+    ifstream file(path);
+    string line, id, name, grade;
+    bytes = 0;
+    while (bytes < limit && getline(file, line)) {
+        bytes += line.size() + 1;
+        stringstream fields(line);
+        getline(fields, id, ',');
+        getline(fields, name, ',');
+        getline(fields, grade);
+        auto& total = totals[id];
+        total.first += stod(grade);
+        total.second++;
+    }
+}
+
+// The mmap totals against the getline ones: same students, same sums.
+bool sameTotals(const vector<StudentTotal>& totals, const GetlineTotals& expected) {
+    if (totals.size() != expected.size()) {
+        return false;
+    }
+    for (const StudentTotal& total : totals) {
+        auto found = expected.find(string(total.id));
+        if (found == expected.end() || found->second.second != total.grade_count ||
+            llround(found->second.first * 100) != static_cast<long long>(total.grade_sum)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    double gigabytes = argc > 1 ? stod(argv[1]) : 10;
+    string path = argc > 2 ? argv[2] : "grades_large.csv";
+
+    auto start = chrono::steady_clock::now();
+    writeGrades(path, static_cast<uint64_t>(gigabytes * 1e9));
+    MappedFile file(path);
+    cout << file.size() << " bytes written in " << secondsSince(start) << " s, " << STUDENTS << " students, "
+         << thread::hardware_concurrency() << " hardware threads\n";
+
+    // The first GB, cut at a line end.
+    size_t cached = min<size_t>(file.size(), size_t(1) << 30);
+    cached = string_view(file.data(), cached).rfind('\n') + 1;
+
+    uint64_t bytes;
+    GetlineTotals expected;
+    start = chrono::steady_clock::now();
+    getlineAverages(path, cached, bytes, expected);
+    cout << "  ifstream + getline (first GB)  " << bytes / secondsSince(start) / 1e9 << " GB/s  (" << expected.size()
+         << " students)\n";
+
+    // The whole file, once per thread count: read from disk when it does
+    // not fit in the page cache.
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        start = chrono::steady_clock::now();
+        vector<StudentTotal> totals = averageGrades(file.data(), file.size(), threads);
+        double seconds = secondsSince(start);
+        uint64_t rows = 0;
+        for (const StudentTotal& total : totals) {
+            rows += total.grade_count;
+        }
+        cout << "  mmap, " << threads << " thread" << (threads > 1 ? "s " : "  ") << "              "
+             << file.size() / seconds / 1e9 << " GB/s  (" << totals.size() << " students, " << rows << " rows, "
+             << totals[0].id << " " << totals[0].name << " " << totals[0].average() << ")\n";
+    }
+
+    // The first GB again, now in the page cache, checked against getline.
+    averageGrades(file.data(), cached, 1);
+    for (unsigned threads : {1u, 4u}) {
+        start = chrono::steady_clock::now();
+        vector<StudentTotal> totals = averageGrades(file.data(), cached, threads);
+        cout << "  mmap, first GB cached, " << threads << " thread" << (threads > 1 ? "s " : "  ")
+             << cached / secondsSince(start) / 1e9 << " GB/s  (" << totals.size() << " students)"
+             << (sameTotals(totals, expected) ? "" : " MISMATCH") << "\n";
+    }
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,160 @@
+// g++ -O2 -std=c++17 student_store.cpp -o student_store
+//
+//   ./student_store [rows] [csv file]
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "StudentStore.hpp"
+using namespace std;
+
+const char* MALE[] = {"Александър", "Георги", "Иван",   "Николай", "Стоян",  "Димитър", "Любомир",
+                      "Красимир",   "Петър",  "Тодор",  "Васил",   "Христо", "Мартин",  "Калоян",
+                      "Борис",      "Виктор", "Стефан", "Емил",    "Пламен", "Янко"};
+const char* FEMALE[] = {"Мария",     "Елена",  "Христина", "Петя",   "Виктория", "Радослава", "Теодора",
+                        "Десислава", "Гергана", "Ивана",   "Надежда", "Милена",  "Светла",    "Цветелина",
+                        "Йоана",     "Кристина", "Силвия", "Росица", "Анна",     "Евгения"};
+const char* SURNAMES[] = {"Петров", "Иванов", "Димитров", "Георгиев", "Николов", "Стоянов", "Василев",
+                          "Атанасов", "Тодоров", "Костов", "Христов", "Маринов", "Симеонов", "Колев",
+                          "Йорданов", "Ангелов", "Попов",  "Илиев",   "Михайлов", "Павлов"};
+
+// Student s of the generated data: a unique faculty number ("0MI0200123")
+// and a name with a father's name, both fixed by s.
+string studentId(uint64_t s) {
+    // Multiplying by a number coprime to 10^8 permutes 0 .. 10^8-1.
+    uint64_t number = s * 48271 % 100000000;
+    char id[16];
+    snprintf(id, sizeof(id), "%lluMI%07llu", (unsigned long long)(number / 10000000),
+             (unsigned long long)(number % 10000000));
+    return id;
+}
+
+string studentName(uint64_t s) {
+    uint64_t h = s * 0x9E3779B97F4A7C15ULL;
+    bool female = h >> 63;
+    string name = female ? FEMALE[h % 20] : MALE[h % 20];
+    const char* suffix = female ? "а" : "";
+    name += string(" ") + SURNAMES[h / 20 % 20] + suffix;
+    name += string(" ") + SURNAMES[h / 400 % 20] + suffix;
+    return name;
+}
+
+// Mostly one row per student as in students.csv; one row in ten is another
+// grade of an earlier student.
+void writeCsv(const string& path, size_t rows, vector<uint64_t>& students) {
+    ofstream out(path, ios::binary);
+    mt19937_64 rng(47);
+    string buffer;
+    for (size_t row = 0; row < rows; ++row) {
+        uint64_t s;
+        if (students.empty() || rng() % 10) {
+            s = students.size();
+            students.push_back(s);
+        } else {
+            s = students[rng() % students.size()];
+        }
+        // 2.00 .. 6.00 in steps of 0.25.
+        unsigned quarters = 8 + static_cast<unsigned>(rng() % 17);
+        char grade[8];
+        snprintf(grade, sizeof(grade), "%u.%02u", quarters / 4, quarters % 4 * 25);
+        buffer += studentId(s) + "," + studentName(s) + "," + grade + "\n";
+        if (buffer.size() > (1 << 20)) {
+            out << buffer;
+            buffer.clear();
+        }
+    }
+    out << buffer;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Runs query(i) for i < count; prints the time per query and the matches.
+template <typename Query>
+void measure(const string& name, size_t count, Query query) {
+    auto start = chrono::steady_clock::now();
+    uint64_t matches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        matches += query(i);
+    }
+    double seconds = secondsSince(start);
+    cout << "  " << name << seconds / count * 1e9 << " ns/query, " << double(matches) / count
+         << " matches/query\n";
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? stoull(argv[1]) : 50000000;
+    string path = argc > 2 ? argv[2] : "students_large.csv";
+
+    vector<uint64_t> students;
+    auto start = chrono::steady_clock::now();
+    writeCsv(path, rows, students);
+    size_t bytes = static_cast<size_t>(ifstream(path, ios::binary | ios::ate).tellg());
+    cout << rows << " rows, " << students.size() << " students, " << bytes / 1e6 << " MB written in "
+         << secondsSince(start) << " s\n";
+
+    start = chrono::steady_clock::now();
+    StudentStore store = StudentStore::fromFile(path);
+    double load = secondsSince(start);
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << "load: " << load << " s (" << bytes / load / 1e6 << " MB/s, " << rows / load / 1e6
+         << " M rows/s), " << store.size() << " students, " << store.distinctNames()
+         << " distinct names, peak RSS " << usage.ru_maxrss / 1024 << " MB\n";
+
+    mt19937_64 rng(7);
+    const size_t QUERIES = 1000000;
+    vector<string> present(QUERIES), missing(QUERIES);
+    for (size_t i = 0; i < QUERIES; ++i) {
+        present[i] = studentId(students[rng() % students.size()]);
+        missing[i] = studentId(students.size() + rng() % 1000000);
+    }
+
+    cout << "queries:\n";
+    measure("findById, present           ", QUERIES,
+            [&](size_t i) { return store.findById(present[i]).has_value(); });
+    measure("findById, missing           ", QUERIES,
+            [&](size_t i) { return store.findById(missing[i]).has_value(); });
+    measure("linear scan by ID           ", 3, [&](size_t i) {
+        size_t found = 0;
+        for (uint32_t s = 0; s < store.size(); ++s) {
+            found += store.id(s) == present[i];
+        }
+        return found;
+    });
+
+    vector<string> names(1000);
+    for (string& name : names) {
+        name = studentName(rng());
+    }
+    measure("findByName                  ", 1000000,
+            [&](size_t i) { return store.findByName(names[i % names.size()]).size(); });
+    measure("findByNamePrefix \"Мария\"    ", 1000000,
+            [&](size_t) { return store.findByNamePrefix("Мария").size(); });
+    measure("findByNamePrefix \"Мария Пе\" ", 1000000,
+            [&](size_t) { return store.findByNamePrefix("Мария Пе").size(); });
+    measure("findByAverage [4.50, 5.00]  ", 1000000,
+            [&](size_t) { return store.findByAverage(4.50, 5.00).size(); });
+    measure("findByAverage [5.30, 5.35]  ", 1000000,
+            [&](size_t) { return store.findByAverage(5.30, 5.35).size(); });
+    // Reading the result too: the average of every match.
+    measure("findByAverage [4.50, 5.00] + read averages ", 10, [&](size_t) {
+        double sum = 0;
+        StudentStore::Matches matches = store.findByAverage(4.50, 5.00);
+        for (uint32_t s : matches) {
+            sum += store.average(s);
+        }
+        return matches.size() + (sum < 0);
+    });
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+// Reference counts for the nodes of PersistentList. SingleThreaded is a
+// plain counter; ThreadSafe lets snapshots be handed to and dropped from
+// other threads.
+struct SingleThreaded
+{
+	using Count = size_t;
+
+	static void retain(Count& count) { count++; }
+	// True when this was the last reference.
+	static bool release(Count& count) { return --count == 0; }
+	static bool isUnique(const Count& count) { return count == 1; }
+};
+
+struct ThreadSafe
+{
+	using Count = std::atomic<size_t>;
+
+	static void retain(Count& count) { count.fetch_add(1, std::memory_order_relaxed); }
+	static bool release(Count& count) { return count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+	static bool isUnique(const Count& count) { return count.load(std::memory_order_acquire) == 1; }
+};
+
+// Immutable singly linked list (cons list) whose tails are shared.
+//
+// A PersistentList is a handle to its first node. Nodes are never changed
+// after they are created, so copying a handle is a snapshot: O(1), no
+// nodes copied. pushFront / popFront only move this handle - a new node in
+// front of the old head, or the head one step further - and every other
+// handle keeps seeing its own list. Each node counts the handles and nodes
+// pointing at it (intrusive count) and is freed with the last of them.
+//
+// Used as a stack: pushFront / popFront / front.
+template <typename T, typename RefCount = SingleThreaded>
+class PersistentList
+{
+private:
+	struct Node
+	{
+		T data;
+		Node* next;
+		typename RefCount::Count refs;
+
+		Node(const T& value, Node* next) : data(value), next(next), refs(1) {}
+	};
+
+	Node* head = nullptr;
+	size_t size = 0;
+
+public:
+	PersistentList() = default;
+	PersistentList(const PersistentList<T, RefCount>& other);
+	PersistentList(PersistentList<T, RefCount>&& other) noexcept;
+
+	PersistentList<T, RefCount>& operator=(const PersistentList<T, RefCount>& other);
+	PersistentList<T, RefCount>& operator=(PersistentList<T, RefCount>&& other) noexcept;
+	~PersistentList();
+
+	void pushFront(const T& value);
+	void popFront();
+
+	// The same as a copy; reads better at the call site.
+	PersistentList<T, RefCount> snapshot() const { return *this; }
+
+	const T& front() const;
+
+	size_t getSize() const;
+	bool isEmpty() const;
+
+	// True when both share the same first node (and so the same elements).
+	bool sharesWith(const PersistentList<T, RefCount>& other) const { return head == other.head; }
+
+	// ==================== Iterator Class ====================
+
+	// The elements are shared between snapshots, so only const access.
+	class ConstIterator
+	{
+	private:
+		const Node* currentNode;
+		friend class PersistentList;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		explicit ConstIterator(const Node* node = nullptr) : currentNode(node) {}
+
+		const T& operator*() const { return currentNode->data; }
+		const T* operator->() const { return &currentNode->data; }
+
+		ConstIterator& operator++()
+		{
+			if (currentNode)
+				currentNode = currentNode->next;
+			return *this;
+		}
+
+		ConstIterator operator++(int)
+		{
+			ConstIterator temp(*this);
+			++(*this);
+			return temp;
+		}
+
+		ConstIterator& operator+=(size_t offset)
+		{
+			while (offset--)
+				++(*this);
+			return *this;
+		}
+
+		ConstIterator operator+(int offset) const
+		{
+			ConstIterator temp(*this);
+			return temp += offset;
+		}
+
+		bool operator==(const ConstIterator& other) const
+		{
+			return currentNode == other.currentNode;
+		}
+
+		bool operator!=(const ConstIterator& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	ConstIterator begin() const { return ConstIterator(head); }
+	ConstIterator end() const { return ConstIterator(nullptr); }
+
+	ConstIterator cbegin() const { return ConstIterator(head); }
+	ConstIterator cend() const { return ConstIterator(nullptr); }
+
+private:
+	// Drops one reference to node and frees whatever that leaves unused,
+	// iteratively (a long list must not recurse).
+	static void release(Node* node);
+};
+
+template <typename T, typename RefCount>
+void PersistentList<T, RefCount>::release(Node* node)
+{
+	while (node && RefCount::release(node->refs))
+	{
+		Node* next = node->next;
+		delete node;
+		node = next;
+	}
+}
+
+template <typename T, typename RefCount>
+void PersistentList<T, RefCount>::pushFront(const T& value)
+{
+	// The new node takes over this handle's reference to the old head.
+	head = new Node(value, head);
+	size++;
+}
+
+template <typename T, typename RefCount>
+void PersistentList<T, RefCount>::popFront()
+{
+	if (!head)
+		throw std::logic_error("Cannot pop from an empty list!");
+
+	Node* oldHead = head;
+	head = head->next;
+	size--;
+
+	if (RefCount::isUnique(oldHead->refs))
+	{
+		// Nobody else sees the old head: its reference to the next node
+		// passes to this handle.
+		delete oldHead;
+	}
+	else
+	{
+		if (head)
+			RefCount::retain(head->refs);
+		release(oldHead);
+	}
+}
+
+template <typename T, typename RefCount>
+const T& PersistentList<T, RefCount>::front() const
+{
+	if (!head)
+		throw std::logic_error("Cannot access front of an empty list!");
+
+	return head->data;
+}
+
+template <typename T, typename RefCount>
+size_t PersistentList<T, RefCount>::getSize() const
+{
+	return size;
+}
+
+template <typename T, typename RefCount>
+bool PersistentList<T, RefCount>::isEmpty() const
+{
+	return size == 0;
+}
+
+template <typename T, typename RefCount>
+PersistentList<T, RefCount>::PersistentList(const PersistentList<T, RefCount>& other)
+	: head(other.head), size(other.size)
+{
+	if (head)
+		RefCount::retain(head->refs);
+}
+
+template <typename T, typename RefCount>
+PersistentList<T, RefCount>::PersistentList(PersistentList<T, RefCount>&& other) noexcept
+	: head(other.head), size(other.size)
+{
+	other.head = nullptr;
+	other.size = 0;
+}
+
+template <typename T, typename RefCount>
+PersistentList<T, RefCount>& PersistentList<T, RefCount>::operator=(const PersistentList<T, RefCount>& other)
+{
+	if (this != &other)
+	{
+		// Retain first: other may be reachable only through this list.
+		if (other.head)
+			RefCount::retain(other.head->refs);
+		release(head);
+		head = other.head;
+		size = other.size;
+	}
+	return *this;
+}
+
+template <typename T, typename RefCount>
+PersistentList<T, RefCount>& PersistentList<T, RefCount>::operator=(PersistentList<T, RefCount>&& other) noexcept
+{
+	if (this != &other)
+	{
+		release(head);
+		head = other.head;
+		size = other.size;
+		other.head = nullptr;
+		other.size = 0;
+	}
+	return *this;
+}
+
+template <typename T, typename RefCount>
+PersistentList<T, RefCount>::~PersistentList()
+{
+	release(head);
+}
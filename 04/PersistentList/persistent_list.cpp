@@ -0,0 +1,105 @@
+// g++ -O2 -std=c++17 persistent_list.cpp -o persistent_list
+//
+//   ./persistent_list [elements] [snapshots]
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../SinglyLinkedList/generic/SinglyLinkedList.hpp"
+#include "PersistentList.hpp"
+using namespace std;
+
+// Live heap bytes, counted in the global operator new / delete.
+size_t liveBytes = 0;
+
+void* operator new(size_t size)
+{
+	void* p = malloc(size);
+	if (!p)
+		throw bad_alloc();
+	liveBytes += malloc_usable_size(p);
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	if (p)
+	{
+		liveBytes -= malloc_usable_size(p);
+		free(p);
+	}
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Undo history: every step edits the stack (two pushes, one pop) and keeps
+// a snapshot of the result. Returns a checksum of what the snapshots hold.
+template <typename List>
+int64_t editWithHistory(List& state, size_t steps, vector<List>& history)
+{
+	for (size_t step = 0; step < steps; ++step)
+	{
+		if (step % 3 == 2)
+			state.popFront();
+		else
+			state.pushFront(static_cast<int>(step));
+		history.push_back(state);
+	}
+
+	int64_t checksum = 0;
+	for (List& snapshot : history)
+		checksum += snapshot.front() + static_cast<int64_t>(snapshot.getSize());
+	return checksum;
+}
+
+template <typename List>
+void measure(const string& name, size_t elements, size_t steps)
+{
+	List state;
+	for (size_t i = 0; i < elements; ++i)
+		state.pushFront(static_cast<int>(i));
+
+	// Held: the history (handles or copies) and every node it keeps alive.
+	size_t before = liveBytes;
+	vector<List> history;
+	history.reserve(steps);
+
+	auto start = chrono::steady_clock::now();
+	int64_t checksum = editWithHistory(state, steps, history);
+	double seconds = secondsSince(start);
+	size_t held = liveBytes - before;
+
+	start = chrono::steady_clock::now();
+	history.clear();
+	double freeSeconds = secondsSince(start);
+
+	cout << "  " << name << steps << " snapshots: " << seconds / steps * 1e9 << " ns/snapshot, "
+		 << double(held) / steps << " bytes/snapshot held, freed in " << freeSeconds * 1e3 << " ms (checksum "
+		 << checksum << ")\n";
+}
+
+int main(int argc, char** argv)
+{
+	size_t elements = argc > 1 ? stoull(argv[1]) : 100000;
+	size_t snapshots = argc > 2 ? stoull(argv[2]) : 1000000;
+	// Full copies of the stack: a few hundred fit in memory.
+	size_t copies = min<size_t>(snapshots, max<size_t>(1, 20000000 / max<size_t>(elements, 1)));
+
+	cout << "stack of " << elements << " ints, edited and snapshotted:\n";
+	measure<SinglyLinkedList<int>>("SinglyLinkedList (copy)         ", elements, copies);
+	measure<PersistentList<int>>("PersistentList                  ", elements, snapshots);
+	measure<PersistentList<int, ThreadSafe>>("PersistentList<ThreadSafe>      ", elements, snapshots);
+	return 0;
+}
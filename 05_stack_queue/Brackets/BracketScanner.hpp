@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Bracket checks of tasks 1 and 2 for inputs of any size, fed in chunks of
+// any size (a file or a socket, one read at a time).
+//
+// The input is cut in 64-byte blocks. For each block the positions of the
+// brackets are found at once as 64-bit masks (AVX2: 32 bytes per compare),
+// so text between brackets costs nothing beyond the compares.
+//
+//   BracketValidator - tasks 1 + 2: ( [ { must be closed by the same kind.
+//     Walks the bracket positions of each block (one tzcnt each) with no
+//     branch on open / close: the stack of open kinds is a byte array that
+//     is always written one above the top and the depth moves by +-1.
+//     Optionally skips brackets inside JSON strings ("...", with \"
+//     escapes). Reports the offset of the first error.
+//   BracketDepth - task 2 only: nesting depth, any kind closing any kind.
+//     Needs no stack at all: +1 / -1 per byte, prefix sums over the block,
+//     block minimum and maximum added to the running depth.
+//
+// Other characters are ignored (task 1's isValid counts them as closing
+// brackets).
+
+struct BracketError {
+    enum Kind {
+        None,
+        Mismatch,            // ')' closing '[' ...
+        UnexpectedClose,     // closing bracket at depth 0
+        Unclosed,            // input ended with open brackets
+        UnterminatedString,  // input ended inside a JSON string
+    };
+
+    Kind kind = None;
+    uint64_t offset = 0;  // of the offending byte; the input size at the end
+};
+
+namespace bracket_blocks {
+
+const size_t BLOCK = 64;
+
+// Bit i describes byte i of the block.
+struct Masks {
+    uint64_t open = 0;
+    uint64_t close = 0;
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+};
+
+#ifdef __AVX2__
+inline uint64_t bits(__m256i lo, __m256i hi) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(lo)) |
+           static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32;
+}
+
+inline __m256i equal(__m256i v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+#endif
+
+inline Masks classify(const char* block, bool strings) {
+    Masks masks;
+#ifdef __AVX2__
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    masks.open = bits(_mm256_or_si256(_mm256_or_si256(equal(lo, '('), equal(lo, '[')), equal(lo, '{')),
+                      _mm256_or_si256(_mm256_or_si256(equal(hi, '('), equal(hi, '[')), equal(hi, '{')));
+    masks.close = bits(_mm256_or_si256(_mm256_or_si256(equal(lo, ')'), equal(lo, ']')), equal(lo, '}')),
+                       _mm256_or_si256(_mm256_or_si256(equal(hi, ')'), equal(hi, ']')), equal(hi, '}')));
+    if (strings) {
+        masks.quote = bits(equal(lo, '"'), equal(hi, '"'));
+        masks.backslash = bits(equal(lo, '\\'), equal(hi, '\\'));
+    }
+#else
+    // Bit 0 open, 1 close, 2 quote, 3 backslash.
+    static const struct Table {
+        uint8_t of[256] = {};
+        Table() {
+            of['('] = of['['] = of['{'] = 1;
+            of[')'] = of[']'] = of['}'] = 2;
+            of['"'] = 4;
+            of['\\'] = 8;
+        }
+    } table;
+    // 8 bytes at a time: their classes side by side in one word, then the
+    // multiply gathers bit k of every byte into 8 consecutive bits.
+    const uint64_t LOW_BITS = 0x0101010101010101ULL;
+    const uint64_t GATHER = 0x0102040810204080ULL;
+    for (size_t i = 0; i < BLOCK; i += 8) {
+        uint64_t classes = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            classes |= static_cast<uint64_t>(table.of[static_cast<uint8_t>(block[i + j])]) << (8 * j);
+        }
+        masks.open |= ((classes & LOW_BITS) * GATHER >> 56) << i;
+        masks.close |= ((classes >> 1 & LOW_BITS) * GATHER >> 56) << i;
+        masks.quote |= ((classes >> 2 & LOW_BITS) * GATHER >> 56) << i;
+        masks.backslash |= ((classes >> 3 & LOW_BITS) * GATHER >> 56) << i;
+    }
+    if (!strings) {
+        masks.quote = masks.backslash = 0;
+    }
+#endif
+    return masks;
+}
+
+// Bits of the characters escaped by a backslash. escaped_carry: the last
+// byte of the previous block was an unescaped backslash.
+inline uint64_t escaped(uint64_t backslash, uint64_t& escaped_carry) {
+    const uint64_t EVEN = 0x5555555555555555ULL;
+    backslash &= ~escaped_carry;
+    uint64_t follows = backslash << 1 | escaped_carry;
+    // A run of backslashes escapes every second byte after its start. Adding
+    // the runs that start on an odd bit to the backslash mask carries them
+    // past their end, which flips the parity used for those runs.
+    uint64_t odd_starts = backslash & ~EVEN & ~follows;
+    uint64_t carried = odd_starts + backslash;
+    escaped_carry = carried < odd_starts ? 1 : 0;
+    return (EVEN ^ (carried << 1)) & follows;
+}
+
+// Bit i set when byte i is inside a string: the XOR of all quote bits up to
+// and including i (the opening quote is in, the closing one out).
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+}  // namespace bracket_blocks
+
+class BracketValidator {
+public:
+    // json_strings: brackets between unescaped double quotes do not count.
+    explicit BracketValidator(bool json_strings = false) : strings(json_strings), stack(256, 0) {}
+
+    // Returns false once an error has been found; later calls are ignored.
+    bool feed(const char* data, size_t n);
+    // End of input: reports anything still open.
+    bool finish();
+
+    bool ok() const { return failure.kind == BracketError::None; }
+    const BracketError& error() const { return failure; }
+    // Deepest nesting seen so far.
+    uint64_t maxDepth() const { return max_depth; }
+    uint64_t depth() const { return current; }
+
+private:
+    bool strings;
+    // stack[1 .. current] are the open kinds ('(' >> 5 = 1, '[' -> 2,
+    // '{' -> 3); stack[0] = 0 matches no closing bracket.
+    std::vector<uint8_t> stack;
+    uint64_t current = 0;
+    uint64_t max_depth = 0;
+    uint64_t consumed = 0;  // bytes before the current block
+    uint64_t in_string = 0;  // all ones while inside a string
+    uint64_t escaped_carry = 0;
+    char pending[bracket_blocks::BLOCK];
+    size_t pending_size = 0;
+    BracketError failure;
+
+    void block(const char* data);
+    void fail(BracketError::Kind kind, uint64_t offset) { failure = {kind, offset}; }
+};
+
+inline void BracketValidator::block(const char* data) {
+    using namespace bracket_blocks;
+    Masks masks = classify(data, strings);
+    uint64_t brackets = masks.open | masks.close;
+    if (strings) {
+        uint64_t quotes = masks.quote & ~escaped(masks.backslash, escaped_carry);
+        uint64_t inside = prefixXor(quotes) ^ in_string;
+        in_string = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+        brackets &= ~inside;
+    }
+    if (current + BLOCK + 1 >= stack.size()) {
+        stack.resize(2 * stack.size());
+    }
+
+    uint8_t* kinds = stack.data();
+    uint64_t depth = current;
+    uint64_t deepest = max_depth;
+    while (brackets) {
+        unsigned position = static_cast<unsigned>(__builtin_ctzll(brackets));
+        brackets &= brackets - 1;
+        uint8_t kind = static_cast<uint8_t>(data[position]) >> 5;
+        uint64_t is_open = (masks.open >> position) & 1;
+        bool bad = !is_open && kinds[depth] != kind;
+        kinds[depth + 1] = kind;
+        if (bad) {
+            fail(depth == 0 ? BracketError::UnexpectedClose : BracketError::Mismatch, consumed + position);
+            break;
+        }
+        depth += 2 * is_open - 1;
+        deepest = std::max(deepest, depth);
+    }
+    current = depth;
+    max_depth = deepest;
+    consumed += BLOCK;
+}
+
+inline bool BracketValidator::feed(const char* data, size_t n) {
+    using bracket_blocks::BLOCK;
+    if (!ok()) {
+        return false;
+    }
+    if (pending_size > 0) {
+        size_t take = std::min(n, BLOCK - pending_size);
+        std::memcpy(pending + pending_size, data, take);
+        pending_size += take;
+        data += take;
+        n -= take;
+        if (pending_size < BLOCK) {
+            return true;
+        }
+        block(pending);
+        pending_size = 0;
+    }
+    for (; n >= BLOCK && ok(); data += BLOCK, n -= BLOCK) {
+        block(data);
+    }
+    if (ok()) {
+        std::memcpy(pending, data, n);
+        pending_size = n;
+    }
+    return ok();
+}
+
+inline bool BracketValidator::finish() {
+    if (!ok()) {
+        return false;
+    }
+    uint64_t size = consumed + pending_size;
+    if (pending_size > 0) {
+        // Zero padding holds no brackets, quotes or backslashes.
+        std::memset(pending + pending_size, 0, bracket_blocks::BLOCK - pending_size);
+        block(pending);
+        pending_size = 0;
+        if (!ok()) {
+            return false;
+        }
+    }
+    if (in_string) {
+        fail(BracketError::UnterminatedString, size);
+    } else if (current > 0) {
+        fail(BracketError::Unclosed, size);
+    }
+    return ok();
+}
+
+class BracketDepth {
+public:
+    // Same contract as BracketValidator; only UnexpectedClose and Unclosed
+    // can be reported.
+    bool feed(const char* data, size_t n);
+    bool finish();
+
+    bool ok() const { return failure.kind == BracketError::None; }
+    const BracketError& error() const { return failure; }
+    uint64_t maxDepth() const { return max_depth; }
+    uint64_t depth() const { return static_cast<uint64_t>(current); }
+
+private:
+    int64_t current = 0;
+    int64_t max_depth = 0;
+    uint64_t consumed = 0;
+    char pending[bracket_blocks::BLOCK];
+    size_t pending_size = 0;
+    BracketError failure;
+
+    void block(const char* data);
+    // Scalar walk of one block, for the tail and to find an error offset.
+    void walk(const char* data, size_t n);
+};
+
+inline void BracketDepth::walk(const char* data, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        char c = data[i];
+        if (c == '(' || c == '[' || c == '{') {
+            max_depth = std::max(max_depth, ++current);
+        } else if (c == ')' || c == ']' || c == '}') {
+            if (current == 0) {
+                failure = {BracketError::UnexpectedClose, consumed + i};
+                return;
+            }
+            current--;
+        }
+    }
+    consumed += n;
+}
+
+inline void BracketDepth::block(const char* data) {
+    using bracket_blocks::BLOCK;
+#ifdef __AVX2__
+    // +1 / -1 per byte as int8 (compares give -1), inclusive prefix sums
+    // over all 64 bytes: |sum| <= 64 fits.
+    using bracket_blocks::equal;
+    __m256i sums[2];
+    for (int half = 0; half < 2; ++half) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32 * half));
+        __m256i open = _mm256_or_si256(_mm256_or_si256(equal(v, '('), equal(v, '[')), equal(v, '{'));
+        __m256i close = _mm256_or_si256(_mm256_or_si256(equal(v, ')'), equal(v, ']')), equal(v, '}'));
+        __m256i sum = _mm256_sub_epi8(close, open);
+        // Within each 16-byte lane, then the totals of the lanes before.
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 1));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 2));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 4));
+        sum = _mm256_add_epi8(sum, _mm256_slli_si256(sum, 8));
+        __m256i lane_total = _mm256_shuffle_epi8(sum, _mm256_set1_epi8(15));
+        sums[half] = _mm256_add_epi8(sum, _mm256_permute2x128_si256(lane_total, lane_total, 0x08));
+    }
+    __m256i first_total = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(sums[0], _mm256_set1_epi8(15)), 0xff);
+    sums[1] = _mm256_add_epi8(sums[1], first_total);
+
+    // Block maximum and minimum, reduced together: the maximum in the low
+    // 16 bytes, the negated minimum in the high ones.
+    __m256i highs = _mm256_max_epi8(sums[0], sums[1]);
+    __m256i lows = _mm256_min_epi8(sums[0], sums[1]);
+    __m128i high = _mm_max_epi8(_mm256_castsi256_si128(highs), _mm256_extracti128_si256(highs, 1));
+    __m128i low = _mm_min_epi8(_mm256_castsi256_si128(lows), _mm256_extracti128_si256(lows, 1));
+    __m256i both = _mm256_inserti128_si256(_mm256_castsi128_si256(high), _mm_sub_epi8(_mm_setzero_si128(), low), 1);
+    both = _mm256_max_epi8(both, _mm256_srli_si256(both, 8));
+    both = _mm256_max_epi8(both, _mm256_srli_si256(both, 4));
+    both = _mm256_max_epi8(both, _mm256_srli_si256(both, 2));
+    both = _mm256_max_epi8(both, _mm256_srli_si256(both, 1));
+    int64_t highest = static_cast<int8_t>(_mm256_extract_epi8(both, 0));
+    int64_t lowest = -static_cast<int8_t>(_mm256_extract_epi8(both, 16));
+    if (current + lowest < 0) {
+        // Redo the block one byte at a time for the offset.
+        walk(data, BLOCK);
+        return;
+    }
+    max_depth = std::max(max_depth, current + highest);
+    current += static_cast<int8_t>(_mm256_extract_epi8(sums[1], 31));
+    consumed += BLOCK;
+#else
+    walk(data, BLOCK);
+#endif
+}
+
+inline bool BracketDepth::feed(const char* data, size_t n) {
+    using bracket_blocks::BLOCK;
+    if (!ok()) {
+        return false;
+    }
+    if (pending_size > 0) {
+        size_t take = std::min(n, BLOCK - pending_size);
+        std::memcpy(pending + pending_size, data, take);
+        pending_size += take;
+        data += take;
+        n -= take;
+        if (pending_size < BLOCK) {
+            return true;
+        }
+        block(pending);
+        pending_size = 0;
+    }
+    for (; n >= BLOCK && ok(); data += BLOCK, n -= BLOCK) {
+        block(data);
+    }
+    if (ok()) {
+        std::memcpy(pending, data, n);
+        pending_size = n;
+    }
+    return ok();
+}
+
+inline bool BracketDepth::finish() {
+    if (!ok()) {
+        return false;
+    }
+    walk(pending, pending_size);
+    pending_size = 0;
+    if (ok() && current > 0) {
+        failure = {BracketError::Unclosed, consumed};
+    }
+    return ok();
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "BracketScanner.hpp"
+
+// Task 1 + 2 split across threads.
+//
+// After matching everything it can, a piece of the input is left with some
+// closing brackets that nothing in it opened, followed by some opening
+// brackets that nothing in it closes: ")]}" + "{((". That pair is all the
+// rest of the input needs to know about the piece, and two neighbouring
+// pairs combine into the pair of the two pieces together - the openers of
+// the left one are matched against the closers of the right one, innermost
+// first. The combination is associative, so the pieces can be summarised
+// in any order on any threads and merged left to right at the end.
+//
+// A mismatch inside a piece ("(]") is final whatever surrounds it: the
+// summary keeps the first one and stops there. The deepest nesting is
+// kept relative to the depth the piece starts at.
+//
+// Only plain bracket mode: whether a piece starts inside a JSON string is
+// not known until the pieces before it are.
+struct BracketSummary {
+    struct Closer {
+        uint8_t kind;  // '(' >> 5 ...
+        uint64_t offset;
+    };
+
+    std::vector<Closer> closers;   // unmatched, in input order
+    std::vector<uint8_t> openers;  // unmatched kinds, innermost last
+    int64_t max_depth = 0;         // deepest level relative to the start
+    BracketError error;            // first mismatch inside, if any
+
+    // Summary of data[0, n), which starts at `offset` in the whole input.
+    static BracketSummary of(const char* data, size_t n, uint64_t offset);
+
+    // *this becomes the summary of *this followed by next.
+    void append(const BracketSummary& next);
+
+    // The verdict when this is the whole input of `size` bytes.
+    BracketError result(uint64_t size) const;
+};
+
+inline BracketSummary BracketSummary::of(const char* data, size_t n, uint64_t offset) {
+    using namespace bracket_blocks;
+    BracketSummary summary;
+    // kinds[1 .. depth] are the open kinds, kinds[0] = 0 matches no closer.
+    std::vector<uint8_t> kinds(256, 0);
+    uint64_t depth = 0;
+    int64_t deepest = 0;
+    char padded[BLOCK];
+
+    for (size_t start = 0; start < n && summary.error.kind == BracketError::None; start += BLOCK) {
+        const char* block = data + start;
+        if (n - start < BLOCK) {
+            // Zero padding holds no brackets.
+            std::memset(padded, 0, BLOCK);
+            std::memcpy(padded, block, n - start);
+            block = padded;
+        }
+        Masks masks = classify(block, false);
+        uint64_t brackets = masks.open | masks.close;
+        if (depth + BLOCK + 1 >= kinds.size()) {
+            kinds.resize(2 * kinds.size());
+        }
+        int64_t unmatched = static_cast<int64_t>(summary.closers.size());
+        while (brackets) {
+            unsigned position = static_cast<unsigned>(__builtin_ctzll(brackets));
+            brackets &= brackets - 1;
+            uint8_t kind = static_cast<uint8_t>(block[position]) >> 5;
+            uint64_t is_open = (masks.open >> position) & 1;
+            bool bad = !is_open && kinds[depth] != kind;
+            kinds[depth + 1] = kind;
+            if (bad) {
+                if (depth > 0) {
+                    summary.error = {BracketError::Mismatch, offset + start + position};
+                    break;
+                }
+                // Closes something before this piece.
+                summary.closers.push_back({kind, offset + start + position});
+                unmatched++;
+                continue;
+            }
+            depth += 2 * is_open - 1;
+            deepest = std::max(deepest, static_cast<int64_t>(depth) - unmatched);
+        }
+    }
+    summary.openers.assign(kinds.begin() + 1, kinds.begin() + 1 + depth);
+    summary.max_depth = deepest;
+    return summary;
+}
+
+inline void BracketSummary::append(const BracketSummary& next) {
+    if (error.kind != BracketError::None) {
+        return;  // nothing after the first error matters
+    }
+    int64_t start_depth = static_cast<int64_t>(openers.size()) - static_cast<int64_t>(closers.size());
+    max_depth = std::max(max_depth, start_depth + next.max_depth);
+
+    size_t matched = std::min(openers.size(), next.closers.size());
+    for (size_t i = 0; i < matched; ++i) {
+        if (openers[openers.size() - 1 - i] != next.closers[i].kind) {
+            error = {BracketError::Mismatch, next.closers[i].offset};
+            return;
+        }
+    }
+    openers.resize(openers.size() - matched);
+    closers.insert(closers.end(), next.closers.begin() + matched, next.closers.end());
+    openers.insert(openers.end(), next.openers.begin(), next.openers.end());
+    error = next.error;
+}
+
+inline BracketError BracketSummary::result(uint64_t size) const {
+    // Unmatched closers all come before the first mismatch.
+    if (!closers.empty()) {
+        return {BracketError::UnexpectedClose, closers.front().offset};
+    }
+    if (error.kind != BracketError::None) {
+        return error;
+    }
+    if (!openers.empty()) {
+        return {BracketError::Unclosed, size};
+    }
+    return {};
+}
+
+// Summarises data[0, n) as `threads` pieces in parallel.
+inline BracketSummary summarizeParallel(const char* data, size_t n, unsigned threads) {
+    threads = std::max(1u, threads);
+    // Piece boundaries on block boundaries.
+    size_t piece = (n / threads + bracket_blocks::BLOCK - 1) / bracket_blocks::BLOCK * bracket_blocks::BLOCK;
+    std::vector<BracketSummary> summaries(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = std::min(n, t * piece);
+        size_t end = t + 1 == threads ? n : std::min(n, begin + piece);
+        workers.emplace_back([&summaries, data, t, begin, end]() {
+            summaries[t] = BracketSummary::of(data + begin, end - begin, begin);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        summaries[0].append(summaries[t]);
+    }
+    return summaries[0];
+}
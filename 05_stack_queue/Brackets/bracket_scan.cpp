@@ -0,0 +1,164 @@
+// g++ -O2 -std=c++17 -mavx2 bracket_scan.cpp -o bracket_scan
+//
+//   ./bracket_scan [megabytes]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stack>
+#include <string>
+
+#include "BracketScanner.hpp"
+using namespace std;
+
+// isValid from task 1; non-bracket characters are skipped instead of being
+// taken for closing brackets, and the string is not copied.
+bool isValid(const std::string& s) {
+    std::stack<char> open;
+
+    for (size_t i = 0; i < s.size(); i++) {
+        char ch = s[i];
+        if (ch == '(' || ch == '[' || ch == '{') {
+            open.push(ch);
+        } else if (ch == ')' || ch == ']' || ch == '}') {
+            if (open.empty()) {
+                return false;
+            }
+            if (ch == ')' && open.top() != '(') {
+                return false;
+            }
+            if (ch == ']' && open.top() != '[') {
+                return false;
+            }
+            if (ch == '}' && open.top() != '{') {
+                return false;
+            }
+            open.pop();
+        }
+    }
+
+    return open.empty();
+}
+
+// getMaxParenthesesDepth from task 2, without the copy.
+int getMaxParenthesesDepth(const std::string& s) {
+    int max_depth = 0;
+    std::stack<char> opened;
+
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '(' || c == '[' || c == '{') {
+            opened.push(c);
+            max_depth = std::max(max_depth, (int)opened.size());
+        } else if (c == ')' || c == ']' || c == '}') {
+            if (!opened.empty()) {
+                opened.pop();
+            }
+        }
+    }
+
+    return max_depth;
+}
+
+// One JSON-like record per line; strings may hold (balanced) brackets.
+void appendRecord(string& out, mt19937_64& rng) {
+    out += "{\"id\": " + to_string(rng() % 1000000) + ", \"tags\": [";
+    for (int i = 0, n = static_cast<int>(rng() % 4); i < n; ++i) {
+        out += i ? ", \"t" : "\"t";
+        out += to_string(rng() % 100) + "\"";
+    }
+    out += "], \"pos\": {\"x\": 1.5, \"path\": [[1, 2], [3, [4, 5]]]}, \"note\": \"";
+    out += rng() % 4 ? "plain text, nothing to see" : "see (figure [2]) and {\\\"quoted\\\"}";
+    out += "\"";
+    if (rng() % 8 == 0) {
+        out += ", \"child\": ";
+        appendRecord(out, rng);
+    }
+    out += "}";
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Scanner>
+void stream(Scanner& scanner, const string& input, size_t chunk) {
+    for (size_t offset = 0; offset < input.size(); offset += chunk) {
+        if (!scanner.feed(input.data() + offset, min(chunk, input.size() - offset))) {
+            return;
+        }
+    }
+    scanner.finish();
+}
+
+string describe(const BracketError& error) {
+    const char* names[] = {"valid", "mismatch", "unexpected close", "unclosed", "unterminated string"};
+    return error.kind == BracketError::None ? "valid" : string(names[error.kind]) + " at " + to_string(error.offset);
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? stoull(argv[1]) : 1024;
+    const size_t CHUNK = 1 << 20;  // one read()
+
+    // 64 MB of records, repeated.
+    mt19937_64 rng(83);
+    string base;
+    while (base.size() < (size_t(64) << 20)) {
+        appendRecord(base, rng);
+        base += '\n';
+    }
+    string input;
+    input.reserve(megabytes << 20);
+    while (input.size() + base.size() <= (megabytes << 20)) {
+        input += base;
+    }
+    input.append(base, 0, (megabytes << 20) - input.size());
+    // Cut at the last complete record.
+    input.resize(input.rfind('\n') + 1);
+    double gigabytes = input.size() / 1e9;
+    cout << input.size() << " bytes, " << count(input.begin(), input.end(), '\n') << " records\n";
+
+    auto report = [&](const string& name, double seconds, const string& result) {
+        cout << "  " << name << gigabytes / seconds << " GB/s  (" << result << ")\n";
+    };
+
+    for (bool broken : {false, true}) {
+        if (broken) {
+            // A '}' turned into ']' near the end.
+            size_t at = input.find('}', input.size() - input.size() / 16);
+            input[at] = ']';
+            cout << "with a mismatch at offset " << at << ":\n";
+        } else {
+            cout << "valid input:\n";
+        }
+
+        auto start = chrono::steady_clock::now();
+        bool valid = isValid(input);
+        report("isValid (std::stack)        ", secondsSince(start), valid ? "valid" : "not valid");
+
+        start = chrono::steady_clock::now();
+        BracketValidator validator;
+        stream(validator, input, CHUNK);
+        report("BracketValidator            ", secondsSince(start),
+               describe(validator.error()) + ", max depth " + to_string(validator.maxDepth()));
+
+        start = chrono::steady_clock::now();
+        BracketValidator json_validator(true);
+        stream(json_validator, input, CHUNK);
+        report("BracketValidator, JSON      ", secondsSince(start),
+               describe(json_validator.error()) + ", max depth " + to_string(json_validator.maxDepth()));
+
+        start = chrono::steady_clock::now();
+        int depth = getMaxParenthesesDepth(input);
+        report("getMaxParenthesesDepth      ", secondsSince(start), "max depth " + to_string(depth));
+
+        start = chrono::steady_clock::now();
+        BracketDepth depth_scanner;
+        stream(depth_scanner, input, CHUNK);
+        report("BracketDepth                ", secondsSince(start),
+               describe(depth_scanner.error()) + ", max depth " + to_string(depth_scanner.maxDepth()));
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+// g++ -O2 -std=c++17 -mavx2 -pthread parallel_brackets.cpp -o parallel_brackets
+//
+//   ./parallel_brackets [gigabytes]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BracketScanner.hpp"
+#include "BracketSummary.hpp"
+using namespace std;
+
+// The input is this buffer over and over: 10 GB do not fit in memory here.
+const size_t BASE = size_t(64) << 20;
+
+// Nested records with brackets of all three kinds, one per line.
+void appendRecord(string& out, mt19937_64& rng, int depth) {
+    out += "{\"id\": " + to_string(rng() % 1000000) + ", \"items\": [";
+    for (int i = 0, n = static_cast<int>(rng() % 4); i < n; ++i) {
+        out += i ? ", (" : "(";
+        out += to_string(rng() % 100) + ", [1, 2])";
+    }
+    out += "]";
+    if (depth < 6 && rng() % 4 == 0) {
+        out += ", \"child\": ";
+        appendRecord(out, rng, depth + 1);
+    }
+    out += "}";
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Summary of the bytes [begin, end) of the cycled input, one buffer-sized
+// piece at a time.
+BracketSummary summarizeRange(const string& base, uint64_t begin, uint64_t end) {
+    BracketSummary summary;
+    for (uint64_t offset = begin; offset < end;) {
+        size_t at = offset % BASE;
+        size_t length = static_cast<size_t>(min<uint64_t>(end - offset, BASE - at));
+        summary.append(BracketSummary::of(base.data() + at, length, offset));
+        offset += length;
+    }
+    return summary;
+}
+
+string describe(const BracketError& error) {
+    const char* names[] = {"valid", "mismatch", "unexpected close", "unclosed", "unterminated string"};
+    return error.kind == BracketError::None ? "valid" : string(names[error.kind]) + " at " + to_string(error.offset);
+}
+
+int main(int argc, char** argv) {
+    double requested = argc > 1 ? stod(argv[1]) : 10;
+    uint64_t size = static_cast<uint64_t>(requested * 1e9) / BASE * BASE;
+
+    mt19937_64 rng(89);
+    string base;
+    while (base.size() < BASE) {
+        appendRecord(base, rng, 0);
+        base += '\n';
+    }
+    // Fill the buffer up exactly with blank lines after the last whole record.
+    base.resize(base.rfind('\n', BASE - 1) + 1);
+    base.resize(BASE, '\n');
+    cout << size << " bytes (" << BASE << "-byte buffer cycled), " << thread::hardware_concurrency()
+         << " hardware threads\n";
+
+    auto start = chrono::steady_clock::now();
+    BracketValidator validator;
+    for (uint64_t offset = 0; offset < size; offset += BASE) {
+        validator.feed(base.data(), BASE);
+    }
+    validator.finish();
+    double sequential = secondsSince(start);
+    cout << "  BracketValidator, 1 thread    " << size / sequential / 1e9 << " GB/s  (" << describe(validator.error())
+         << ", max depth " << validator.maxDepth() << ")\n";
+
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        start = chrono::steady_clock::now();
+        uint64_t piece = (size / threads + 63) / 64 * 64;
+        vector<BracketSummary> summaries(threads);
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            uint64_t begin = min(size, t * piece);
+            uint64_t end = t + 1 == threads ? size : min(size, begin + piece);
+            workers.emplace_back([&, t, begin, end]() { summaries[t] = summarizeRange(base, begin, end); });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        for (unsigned t = 1; t < threads; ++t) {
+            summaries[0].append(summaries[t]);
+        }
+        double seconds = secondsSince(start);
+        BracketError error = summaries[0].result(size);
+        bool same = error.kind == validator.error().kind && error.offset == validator.error().offset &&
+                    static_cast<uint64_t>(summaries[0].max_depth) == validator.maxDepth();
+        cout << "  summaries, " << threads << (threads < 10 ? " " : "") << " threads         "
+             << size / seconds / 1e9 << " GB/s, x" << sequential / seconds << "  (" << describe(error)
+             << ", max depth " << summaries[0].max_depth << ")" << (same ? "" : "  MISMATCH") << "\n";
+    }
+    return 0;
+}
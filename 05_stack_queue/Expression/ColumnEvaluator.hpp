@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "Expression.hpp"
+
+// Runs a CompiledExpression over columns instead of rows: columns[v] is the
+// array of values of variable v, out[r] the result for row r.
+//
+// The rows are processed in chunks of CHUNK. Within a chunk every
+// instruction is one loop over all of its rows, so the switch on the opcode
+// runs once per CHUNK rows instead of once per row, and the loops are
+// vectorised (4 doubles / 8 floats per AVX2 operation). The evaluation
+// stack holds whole chunks:
+//   - a variable is a pointer into its column, nothing is copied
+//   - a constant stays a scalar (broadcast when used)
+//   - any other result goes to the scratch chunk of its stack depth, the
+//     result of the last instruction straight to out
+//
+// Division by zero gives NaN as in evaluate(); min / max follow std::fmin /
+// std::fmax (a NaN argument is ignored). exp, log and pow run as scalar
+// loops.
+//
+// The scratch chunks are allocated in the constructor and reused, so one
+// evaluator must not be used from several threads at once.
+template <typename T>
+class ColumnEvaluator {
+public:
+    static constexpr size_t CHUNK = 1024;
+
+    explicit ColumnEvaluator(const CompiledExpression& expression);
+
+    void evaluate(const T* const* columns, size_t rows, T* out);
+
+private:
+    // Entry of the evaluation stack: CHUNK values or one repeated value.
+    struct Operand {
+        const T* data;
+        T value;
+    };
+
+    std::vector<Instruction> code;
+    std::vector<T> constants;
+    std::vector<T> scratch;
+
+    template <typename Op>
+    static void unary(Operand& operand, T* dst, size_t n);
+    template <typename Op>
+    static void binary(Operand& lhs, const Operand& rhs, T* dst, size_t n);
+};
+
+#ifdef __AVX2__
+// The AVX2 operations for one element type.
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<double> {
+    using Vec = __m256d;
+    static constexpr size_t WIDTH = 4;
+
+    static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static Vec broadcast(double x) { return _mm256_set1_pd(x); }
+    static Vec nan() { return _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN()); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+    static Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    static Vec sqrt(Vec a) { return _mm256_sqrt_pd(a); }
+    static Vec floor(Vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Vec ceil(Vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+    static Vec negate(Vec a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+    static Vec abs(Vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static Vec isZero(Vec a) { return _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_EQ_OQ); }
+    static Vec isNan(Vec a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+    // mask ? b : a, per lane.
+    static Vec select(Vec a, Vec b, Vec mask) { return _mm256_blendv_pd(a, b, mask); }
+};
+
+template <>
+struct Lanes<float> {
+    using Vec = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static Vec broadcast(float x) { return _mm256_set1_ps(x); }
+    static Vec nan() { return _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static Vec sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+    static Vec floor(Vec a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Vec ceil(Vec a) { return _mm256_round_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+    static Vec negate(Vec a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static Vec abs(Vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Vec isZero(Vec a) { return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ); }
+    static Vec isNan(Vec a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static Vec select(Vec a, Vec b, Vec mask) { return _mm256_blendv_ps(a, b, mask); }
+};
+#endif
+
+// The column operations: scalar() for single values and the tail of a
+// chunk, vector() where there is an AVX2 form (VECTOR).
+namespace column_ops {
+
+struct Add {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return a + b; }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) { return L::add(a, b); }
+#endif
+};
+
+struct Subtract {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return a - b; }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) { return L::sub(a, b); }
+#endif
+};
+
+struct Multiply {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return a * b; }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) { return L::mul(a, b); }
+#endif
+};
+
+struct Divide {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return b == 0 ? std::numeric_limits<T>::quiet_NaN() : a / b; }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) {
+        return L::select(L::div(a, b), L::nan(), L::isZero(b));
+    }
+#endif
+};
+
+// The hardware min / max return the second operand when either is NaN;
+// fmin / fmax return the other one.
+struct Min {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return std::fmin(a, b); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) {
+        return L::select(L::min(a, b), a, L::isNan(b));
+    }
+#endif
+};
+
+struct Max {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a, T b) { return std::fmax(a, b); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a, typename L::Vec b) {
+        return L::select(L::max(a, b), a, L::isNan(b));
+    }
+#endif
+};
+
+struct Pow {
+    static constexpr bool VECTOR = false;
+    template <typename T> static T scalar(T a, T b) { return std::pow(a, b); }
+};
+
+struct Negate {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a) { return -a; }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a) { return L::negate(a); }
+#endif
+};
+
+struct Sqrt {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a) { return std::sqrt(a); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a) { return L::sqrt(a); }
+#endif
+};
+
+struct Abs {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a) { return std::fabs(a); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a) { return L::abs(a); }
+#endif
+};
+
+struct Floor {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a) { return std::floor(a); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a) { return L::floor(a); }
+#endif
+};
+
+struct Ceil {
+    static constexpr bool VECTOR = true;
+    template <typename T> static T scalar(T a) { return std::ceil(a); }
+#ifdef __AVX2__
+    template <typename L> static typename L::Vec vector(typename L::Vec a) { return L::ceil(a); }
+#endif
+};
+
+struct Exp {
+    static constexpr bool VECTOR = false;
+    template <typename T> static T scalar(T a) { return std::exp(a); }
+};
+
+struct Log {
+    static constexpr bool VECTOR = false;
+    template <typename T> static T scalar(T a) { return std::log(a); }
+};
+
+}  // namespace column_ops
+
+template <typename T>
+ColumnEvaluator<T>::ColumnEvaluator(const CompiledExpression& expression)
+    : code(expression.program()),
+      constants(expression.constantPool().begin(), expression.constantPool().end()),
+      scratch(expression.maxDepth() * CHUNK) {}
+
+// operand = Op(operand) for n rows; the result goes to dst unless the
+// operand is a single value.
+template <typename T>
+template <typename Op>
+void ColumnEvaluator<T>::unary(Operand& operand, T* dst, size_t n) {
+    if (!operand.data) {
+        operand.value = Op::scalar(operand.value);
+        return;
+    }
+    const T* a = operand.data;
+    size_t i = 0;
+#ifdef __AVX2__
+    if constexpr (Op::VECTOR) {
+        using L = Lanes<T>;
+        for (; i + L::WIDTH <= n; i += L::WIDTH) {
+            L::store(dst + i, Op::template vector<L>(L::load(a + i)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = Op::scalar(a[i]);
+    }
+    operand.data = dst;
+}
+
+// lhs = Op(lhs, rhs) for n rows, in the same way.
+template <typename T>
+template <typename Op>
+void ColumnEvaluator<T>::binary(Operand& lhs, const Operand& rhs, T* dst, size_t n) {
+    const T* a = lhs.data;
+    const T* b = rhs.data;
+    if (!a && !b) {
+        lhs.value = Op::scalar(lhs.value, rhs.value);
+        return;
+    }
+    size_t i = 0;
+#ifdef __AVX2__
+    if constexpr (Op::VECTOR) {
+        using L = Lanes<T>;
+        if (a && b) {
+            for (; i + L::WIDTH <= n; i += L::WIDTH) {
+                L::store(dst + i, Op::template vector<L>(L::load(a + i), L::load(b + i)));
+            }
+        } else if (a) {
+            typename L::Vec y = L::broadcast(rhs.value);
+            for (; i + L::WIDTH <= n; i += L::WIDTH) {
+                L::store(dst + i, Op::template vector<L>(L::load(a + i), y));
+            }
+        } else {
+            typename L::Vec x = L::broadcast(lhs.value);
+            for (; i + L::WIDTH <= n; i += L::WIDTH) {
+                L::store(dst + i, Op::template vector<L>(x, L::load(b + i)));
+            }
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = Op::scalar(a ? a[i] : lhs.value, b ? b[i] : rhs.value);
+    }
+    lhs.data = dst;
+}
+
+template <typename T>
+void ColumnEvaluator<T>::evaluate(const T* const* columns, size_t rows, T* out) {
+    namespace ops = column_ops;
+    Operand stack[CompiledExpression::MAX_DEPTH];
+    for (size_t start = 0; start < rows; start += CHUNK) {
+        size_t n = std::min(CHUNK, rows - start);
+        Operand* top = stack;  // one past the top element
+        for (size_t k = 0; k < code.size(); ++k) {
+            const Instruction& instruction = code[k];
+            if (instruction.op == OpCode::Constant) {
+                *top++ = {nullptr, constants[instruction.operand]};
+                continue;
+            }
+            if (instruction.op == OpCode::Variable) {
+                *top++ = {columns[instruction.operand] + start, T()};
+                continue;
+            }
+            bool two = instruction.op <= OpCode::Divide || functionArity(instruction.op) == 2;
+            if (two) {
+                top--;
+            }
+            Operand& result = top[-1];
+            T* dst = k + 1 == code.size() ? out + start : &scratch[(top - stack - 1) * CHUNK];
+            switch (instruction.op) {
+                case OpCode::Add: binary<ops::Add>(result, top[0], dst, n); break;
+                case OpCode::Subtract: binary<ops::Subtract>(result, top[0], dst, n); break;
+                case OpCode::Multiply: binary<ops::Multiply>(result, top[0], dst, n); break;
+                case OpCode::Divide: binary<ops::Divide>(result, top[0], dst, n); break;
+                case OpCode::Min: binary<ops::Min>(result, top[0], dst, n); break;
+                case OpCode::Max: binary<ops::Max>(result, top[0], dst, n); break;
+                case OpCode::Pow: binary<ops::Pow>(result, top[0], dst, n); break;
+                case OpCode::Negate: unary<ops::Negate>(result, dst, n); break;
+                case OpCode::Sqrt: unary<ops::Sqrt>(result, dst, n); break;
+                case OpCode::Abs: unary<ops::Abs>(result, dst, n); break;
+                case OpCode::Exp: unary<ops::Exp>(result, dst, n); break;
+                case OpCode::Log: unary<ops::Log>(result, dst, n); break;
+                case OpCode::Floor: unary<ops::Floor>(result, dst, n); break;
+                case OpCode::Ceil: unary<ops::Ceil>(result, dst, n); break;
+                default: break;
+            }
+        }
+        // A lone variable or an all-constant expression ends elsewhere.
+        if (!stack[0].data) {
+            std::fill(out + start, out + start + n, stack[0].value);
+        } else if (stack[0].data != out + start) {
+            std::copy(stack[0].data, stack[0].data + n, out + start);
+        }
+    }
+}
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Arithmetic expressions compiled once to reverse Polish bytecode and then
+// evaluated many times against rows of variable values.
+//
+// compile: the shunting-yard algorithm of task 4, extended with
+//   - literals: 12, 3.75, 1e-3
+//   - named variables (their order is given, a row holds their values)
+//   - unary minus / plus
+//   - functions: sqrt abs exp log floor ceil (1 argument), min max pow (2)
+// The output queue of the algorithm is the program: a flat array of
+// instructions, no strings or trees left. The maximum stack depth is known
+// after compiling, so evaluation runs on a small fixed array and never
+// allocates.
+//
+// Division by zero gives NaN (also 0 / 0), which then propagates through
+// the rest of the expression.
+
+enum class OpCode : uint8_t {
+    Constant,  // push constants[operand]
+    Variable,  // push row[operand]
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    // Functions, one opcode each so evaluation dispatches once.
+    Sqrt,
+    Abs,
+    Exp,
+    Log,
+    Floor,
+    Ceil,
+    Min,  // two arguments from here on
+    Max,
+    Pow,
+    // Only in FormulaBatch programs.
+    Load,    // push temps[operand]
+    Store,   // temps[operand] = top, which stays on the stack
+    Output,  // out[operand] = pop
+};
+
+struct Instruction {
+    OpCode op;
+    uint32_t operand;
+};
+
+const OpCode FIRST_FUNCTION = OpCode::Sqrt;
+const OpCode LAST_FUNCTION = OpCode::Pow;
+
+inline bool isFunction(OpCode op) {
+    return op >= FIRST_FUNCTION && op <= LAST_FUNCTION;
+}
+
+inline int functionArity(OpCode function) {
+    return function >= OpCode::Min ? 2 : 1;
+}
+
+inline const char* functionName(OpCode function) {
+    static const char* const names[] = {"sqrt", "abs", "exp", "log", "floor", "ceil", "min", "max", "pow"};
+    return names[static_cast<int>(function) - static_cast<int>(FIRST_FUNCTION)];
+}
+
+inline double divide(double lhs, double rhs) {
+    return rhs == 0 ? std::numeric_limits<double>::quiet_NaN() : lhs / rhs;
+}
+
+class CompiledExpression {
+public:
+    // Deepest evaluation stack a program may need.
+    static constexpr size_t MAX_DEPTH = 64;
+
+    // Throws std::invalid_argument with the offending position on syntax
+    // errors and unknown names.
+    CompiledExpression(const std::string& source, const std::vector<std::string>& variables);
+
+    // row[i] is the value of variables[i].
+    double evaluate(const double* row) const;
+
+    const std::vector<Instruction>& program() const { return code; }
+    const std::vector<double>& constantPool() const { return constants; }
+    size_t variableCount() const { return variable_count; }
+    size_t maxDepth() const { return max_depth; }
+
+    // The program as text, e.g. "price qty * 1 tax + /".
+    std::string toRpn(const std::vector<std::string>& variables) const;
+
+private:
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    size_t variable_count;
+    size_t max_depth = 0;
+
+    // Entry of the operator stack: a binary or unary operator, or an open
+    // parenthesis (of a function call when is_call).
+    struct Pending {
+        bool is_paren;
+        OpCode op;
+        bool is_call;
+        OpCode function;
+        int arguments;
+        size_t position;
+    };
+
+    void emit(OpCode op, uint32_t operand = 0);
+    static int precedence(OpCode op);
+    [[noreturn]] static void fail(const std::string& message, size_t position);
+};
+
+inline void CompiledExpression::fail(const std::string& message, size_t position) {
+    throw std::invalid_argument(message + " at position " + std::to_string(position));
+}
+
+inline int CompiledExpression::precedence(OpCode op) {
+    switch (op) {
+        case OpCode::Add:
+        case OpCode::Subtract: return 1;
+        case OpCode::Multiply:
+        case OpCode::Divide: return 2;
+        default: return 3;  // unary minus binds tighter than * and /
+    }
+}
+
+inline void CompiledExpression::emit(OpCode op, uint32_t operand) {
+    code.push_back({op, operand});
+}
+
+inline CompiledExpression::CompiledExpression(const std::string& source, const std::vector<std::string>& variables)
+    : variable_count(variables.size()) {
+    std::vector<Pending> operators;
+    bool expect_operand = true;
+    size_t i = 0;
+
+    auto popOperator = [&]() {
+        emit(operators.back().op);
+        operators.pop_back();
+    };
+
+    while (i < source.size()) {
+        char ch = source[i];
+        size_t start = i;
+        if (std::isspace(static_cast<unsigned char>(ch))) {
+            i++;
+            continue;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(ch)) || ch == '.') {
+            if (!expect_operand) {
+                fail("Unexpected number", start);
+            }
+            char* end;
+            double value = std::strtod(source.c_str() + i, &end);
+            if (end == source.c_str() + i) {
+                fail("Invalid number", start);
+            }
+            i = end - source.c_str();
+            constants.push_back(value);
+            emit(OpCode::Constant, static_cast<uint32_t>(constants.size() - 1));
+            expect_operand = false;
+            continue;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_') {
+            while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) {
+                i++;
+            }
+            std::string name = source.substr(start, i - start);
+            if (!expect_operand) {
+                fail("Unexpected name '" + name + "'", start);
+            }
+            size_t next = i;
+            while (next < source.size() && std::isspace(static_cast<unsigned char>(source[next]))) {
+                next++;
+            }
+            if (next < source.size() && source[next] == '(') {
+                int f = static_cast<int>(FIRST_FUNCTION);
+                while (f <= static_cast<int>(LAST_FUNCTION) && name != functionName(static_cast<OpCode>(f))) {
+                    f++;
+                }
+                if (f > static_cast<int>(LAST_FUNCTION)) {
+                    fail("Unknown function '" + name + "'", start);
+                }
+                operators.push_back({true, OpCode::Add, true, static_cast<OpCode>(f), 1, start});
+                i = next + 1;
+                continue;  // still expecting the first argument
+            }
+            size_t v = 0;
+            while (v < variables.size() && variables[v] != name) {
+                v++;
+            }
+            if (v == variables.size()) {
+                fail("Unknown variable '" + name + "'", start);
+            }
+            emit(OpCode::Variable, static_cast<uint32_t>(v));
+            expect_operand = false;
+            continue;
+        }
+
+        i++;
+        if (ch == '(') {
+            if (!expect_operand) {
+                fail("Unexpected '('", start);
+            }
+            operators.push_back({true, OpCode::Add, false, OpCode::Sqrt, 0, start});
+            continue;
+        }
+
+        if (ch == ')' || ch == ',') {
+            if (expect_operand) {
+                fail(std::string("Missing operand before '") + ch + "'", start);
+            }
+            while (!operators.empty() && !operators.back().is_paren) {
+                popOperator();
+            }
+            if (operators.empty()) {
+                fail(ch == ')' ? "Mismatched ')'" : "',' outside of a function call", start);
+            }
+            Pending& paren = operators.back();
+            if (ch == ',') {
+                if (!paren.is_call) {
+                    fail("',' outside of a function call", start);
+                }
+                paren.arguments++;
+                expect_operand = true;
+                continue;
+            }
+            if (paren.is_call) {
+                if (paren.arguments != functionArity(paren.function)) {
+                    fail(std::string(functionName(paren.function)) + " takes " +
+                             std::to_string(functionArity(paren.function)) + " argument(s)",
+                         paren.position);
+                }
+                emit(paren.function);
+            }
+            operators.pop_back();
+            continue;
+        }
+
+        if (ch == '+' || ch == '-' || ch == '*' || ch == '/') {
+            if (expect_operand) {
+                // Prefix sign. Nothing to pop: it applies to what follows.
+                if (ch == '-') {
+                    operators.push_back({false, OpCode::Negate, false, OpCode::Sqrt, 0, start});
+                } else if (ch != '+') {
+                    fail(std::string("Missing operand before '") + ch + "'", start);
+                }
+                continue;
+            }
+            OpCode op = ch == '+' ? OpCode::Add : ch == '-' ? OpCode::Subtract : ch == '*' ? OpCode::Multiply
+                                                                                           : OpCode::Divide;
+            // Left associative: pop operators of higher or equal precedence.
+            while (!operators.empty() && !operators.back().is_paren &&
+                   precedence(operators.back().op) >= precedence(op)) {
+                popOperator();
+            }
+            operators.push_back({false, op, false, OpCode::Sqrt, 0, start});
+            expect_operand = true;
+            continue;
+        }
+
+        fail(std::string("Invalid character '") + ch + "'", start);
+    }
+
+    if (expect_operand) {
+        fail("Missing operand", source.size());
+    }
+    while (!operators.empty()) {
+        if (operators.back().is_paren) {
+            fail("Mismatched '('", operators.back().position);
+        }
+        popOperator();
+    }
+
+    // Depth the program needs; the checks above guarantee it ends at 1.
+    size_t depth = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::Constant:
+            case OpCode::Variable: depth++; break;
+            case OpCode::Negate: break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide: depth--; break;
+            default: depth -= functionArity(instruction.op) - 1; break;
+        }
+        max_depth = std::max(max_depth, depth);
+    }
+    if (max_depth > MAX_DEPTH) {
+        fail("Expression nests too deeply", 0);
+    }
+}
+
+inline double CompiledExpression::evaluate(const double* row) const {
+    double stack[MAX_DEPTH];
+    double* top = stack;  // one past the top element
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::Constant: *top++ = constants[instruction.operand]; break;
+            case OpCode::Variable: *top++ = row[instruction.operand]; break;
+            case OpCode::Add: top--; top[-1] += top[0]; break;
+            case OpCode::Subtract: top--; top[-1] -= top[0]; break;
+            case OpCode::Multiply: top--; top[-1] *= top[0]; break;
+            case OpCode::Divide: top--; top[-1] = divide(top[-1], top[0]); break;
+            case OpCode::Negate: top[-1] = -top[-1]; break;
+            case OpCode::Sqrt: top[-1] = std::sqrt(top[-1]); break;
+            case OpCode::Abs: top[-1] = std::fabs(top[-1]); break;
+            case OpCode::Exp: top[-1] = std::exp(top[-1]); break;
+            case OpCode::Log: top[-1] = std::log(top[-1]); break;
+            case OpCode::Floor: top[-1] = std::floor(top[-1]); break;
+            case OpCode::Ceil: top[-1] = std::ceil(top[-1]); break;
+            case OpCode::Min: top--; top[-1] = std::fmin(top[-1], top[0]); break;
+            case OpCode::Max: top--; top[-1] = std::fmax(top[-1], top[0]); break;
+            case OpCode::Pow: top--; top[-1] = std::pow(top[-1], top[0]); break;
+            case OpCode::Load:
+            case OpCode::Store:
+            case OpCode::Output: break;  // not produced by this compiler
+        }
+    }
+    return stack[0];
+}
+
+inline std::string CompiledExpression::toRpn(const std::vector<std::string>& variables) const {
+    std::string text;
+    for (const Instruction& instruction : code) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        switch (instruction.op) {
+            case OpCode::Constant: {
+                std::string number = std::to_string(constants[instruction.operand]);
+                number.erase(number.find_last_not_of('0') + 1);
+                if (number.back() == '.') {
+                    number.pop_back();
+                }
+                text += number;
+                break;
+            }
+            case OpCode::Variable: text += variables[instruction.operand]; break;
+            case OpCode::Add: text += '+'; break;
+            case OpCode::Subtract: text += '-'; break;
+            case OpCode::Multiply: text += '*'; break;
+            case OpCode::Divide: text += '/'; break;
+            case OpCode::Negate: text += "neg"; break;
+            default: text += functionName(instruction.op); break;
+        }
+    }
+    return text;
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Expression.hpp"
+
+// Many formulas over the same variables compiled into one shared program.
+// evaluate(row, out) sets out[f] to the value of formula f.
+//
+// Each formula is compiled with CompiledExpression and its RPN replayed
+// into one expression DAG, where
+//   - constant folding: an operator with only constant operands becomes a
+//     constant ("365 / 12", "-(2)"), and x * 1, 1 * x, x / 1, x - 0, - - x
+//     become x. Nothing else is rewritten: (x + 1) + 2 is not x + 3 in
+//     floating point.
+//   - common subexpressions: every node is looked up by (op, operands)
+//     before it is created, so equal subtrees - in one formula or across
+//     formulas - are one node. The operands of + * min max are sorted
+//     first, so "price * qty" and "qty * price" are the same node too.
+// The DAG is then emitted once: a node used more than once is computed the
+// first time, kept with Store and later pushed back with Load. Temps are
+// reused once their last Load is emitted.
+//
+// Sethi-Ullman order: for + * min max the operand that needs the deeper
+// stack is emitted first, so the shallower one is computed while only one
+// value waits on the stack.
+//
+// Results match evaluating each formula on its own exactly (the same
+// operations on the same values); only - 0 and * 1 drop the sign of a
+// negative zero.
+class FormulaBatch {
+public:
+    // Throws std::invalid_argument like CompiledExpression, with the number
+    // of the formula in the message.
+    FormulaBatch(const std::vector<std::string>& formulas, const std::vector<std::string>& variables);
+
+    // row[i] is the value of variables[i]; out gets one value per formula.
+    void evaluate(const double* row, double* out);
+
+    size_t formulaCount() const { return formula_count; }
+    const std::vector<Instruction>& program() const { return code; }
+    size_t maxDepth() const { return max_depth; }
+    size_t tempCount() const { return temps.size(); }
+
+    // What the compiler did, for comparison with the formulas compiled one by one.
+    struct Statistics {
+        size_t separate_instructions = 0;
+        size_t separate_max_depth = 0;
+        size_t folded = 0;  // operators replaced by a constant or an operand
+        size_t shared = 0;  // operators found already in the DAG
+    };
+    const Statistics& statistics() const { return stats; }
+
+private:
+    struct Node {
+        OpCode op;
+        uint32_t operand;  // variable index
+        double value;      // constant
+        int lhs;
+        int rhs;  // -1 for unary operators and leaves
+    };
+
+    struct NodeKey {
+        OpCode op;
+        uint64_t payload;  // variable index or constant bits
+        int lhs;
+        int rhs;
+
+        bool operator==(const NodeKey& other) const {
+            return op == other.op && payload == other.payload && lhs == other.lhs && rhs == other.rhs;
+        }
+    };
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const {
+            uint64_t h = key.payload * 0x9e3779b97f4a7c15ULL;
+            h ^= (static_cast<uint64_t>(key.op) << 56) ^ (static_cast<uint64_t>(static_cast<uint32_t>(key.lhs)) << 28) ^
+                 static_cast<uint32_t>(key.rhs);
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    size_t formula_count;
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    std::vector<double> temps;
+    size_t max_depth = 0;
+    Statistics stats;
+
+    // Compile-time only.
+    std::vector<Node> nodes;
+    std::unordered_map<NodeKey, int, NodeKeyHash> node_ids;
+    std::vector<int> uses;   // references from other nodes and from formulas
+    std::vector<int> need;   // Sethi-Ullman stack need
+    std::vector<int> temp;   // temp holding the node, -1 if none yet
+    std::vector<uint32_t> free_temps;
+
+    static bool isCommutative(OpCode op) {
+        return op == OpCode::Add || op == OpCode::Multiply || op == OpCode::Min || op == OpCode::Max;
+    }
+    static double apply(OpCode op, double lhs, double rhs);
+
+    int makeLeaf(OpCode op, uint32_t operand, double value);
+    int makeOperator(OpCode op, int lhs, int rhs);
+    bool isConstant(int id, double value) const {
+        return nodes[id].op == OpCode::Constant && nodes[id].value == value;
+    }
+    void emitNode(int id);
+};
+
+inline double FormulaBatch::apply(OpCode op, double lhs, double rhs) {
+    switch (op) {
+        case OpCode::Add: return lhs + rhs;
+        case OpCode::Subtract: return lhs - rhs;
+        case OpCode::Multiply: return lhs * rhs;
+        case OpCode::Divide: return divide(lhs, rhs);
+        case OpCode::Negate: return -lhs;
+        case OpCode::Sqrt: return std::sqrt(lhs);
+        case OpCode::Abs: return std::fabs(lhs);
+        case OpCode::Exp: return std::exp(lhs);
+        case OpCode::Log: return std::log(lhs);
+        case OpCode::Floor: return std::floor(lhs);
+        case OpCode::Ceil: return std::ceil(lhs);
+        case OpCode::Min: return std::fmin(lhs, rhs);
+        case OpCode::Max: return std::fmax(lhs, rhs);
+        case OpCode::Pow: return std::pow(lhs, rhs);
+        default: throw std::logic_error("Not an operator");
+    }
+}
+
+inline int FormulaBatch::makeLeaf(OpCode op, uint32_t operand, double value) {
+    uint64_t payload = operand;
+    if (op == OpCode::Constant) {
+        std::memcpy(&payload, &value, sizeof(payload));
+    }
+    NodeKey key{op, payload, -1, -1};
+    auto found = node_ids.find(key);
+    if (found != node_ids.end()) {
+        return found->second;
+    }
+    nodes.push_back({op, operand, value, -1, -1});
+    node_ids.emplace(key, static_cast<int>(nodes.size() - 1));
+    return static_cast<int>(nodes.size() - 1);
+}
+
+inline int FormulaBatch::makeOperator(OpCode op, int lhs, int rhs) {
+    bool binary = rhs >= 0;
+    if (nodes[lhs].op == OpCode::Constant && (!binary || nodes[rhs].op == OpCode::Constant)) {
+        stats.folded++;
+        return makeLeaf(OpCode::Constant, 0, apply(op, nodes[lhs].value, binary ? nodes[rhs].value : 0));
+    }
+    if ((op == OpCode::Multiply && isConstant(rhs, 1)) || (op == OpCode::Divide && isConstant(rhs, 1)) ||
+        (op == OpCode::Subtract && isConstant(rhs, 0))) {
+        stats.folded++;
+        return lhs;
+    }
+    if (op == OpCode::Multiply && isConstant(lhs, 1)) {
+        stats.folded++;
+        return rhs;
+    }
+    if (op == OpCode::Negate && nodes[lhs].op == OpCode::Negate) {
+        stats.folded++;
+        return nodes[lhs].lhs;
+    }
+    if (isCommutative(op) && lhs > rhs) {
+        std::swap(lhs, rhs);
+    }
+
+    NodeKey key{op, 0, lhs, rhs};
+    auto found = node_ids.find(key);
+    if (found != node_ids.end()) {
+        stats.shared++;
+        return found->second;
+    }
+    nodes.push_back({op, 0, 0, lhs, rhs});
+    node_ids.emplace(key, static_cast<int>(nodes.size() - 1));
+    return static_cast<int>(nodes.size() - 1);
+}
+
+inline FormulaBatch::FormulaBatch(const std::vector<std::string>& formulas, const std::vector<std::string>& variables)
+    : formula_count(formulas.size()) {
+    // Replay every program on a stack of node ids.
+    std::vector<int> roots;
+    for (size_t f = 0; f < formulas.size(); ++f) {
+        std::vector<int> stack;
+        try {
+            CompiledExpression expression(formulas[f], variables);
+            stats.separate_instructions += expression.program().size();
+            stats.separate_max_depth = std::max(stats.separate_max_depth, expression.maxDepth());
+            for (const Instruction& instruction : expression.program()) {
+                OpCode op = instruction.op;
+                if (op == OpCode::Constant) {
+                    stack.push_back(makeLeaf(op, 0, expression.constantPool()[instruction.operand]));
+                } else if (op == OpCode::Variable) {
+                    stack.push_back(makeLeaf(op, instruction.operand, 0));
+                } else if (op == OpCode::Negate || (isFunction(op) && functionArity(op) == 1)) {
+                    stack.back() = makeOperator(op, stack.back(), -1);
+                } else {
+                    int rhs = stack.back();
+                    stack.pop_back();
+                    stack.back() = makeOperator(op, stack.back(), rhs);
+                }
+            }
+        } catch (const std::invalid_argument& error) {
+            throw std::invalid_argument("Formula " + std::to_string(f) + ": " + error.what());
+        }
+        roots.push_back(stack.back());
+    }
+
+    // Nodes are created after their operands, so one forward pass is
+    // bottom-up. Only nodes reachable from a root count: folding can leave
+    // unused ones behind.
+    uses.assign(nodes.size(), 0);
+    need.assign(nodes.size(), 1);
+    temp.assign(nodes.size(), -1);
+    for (int root : roots) {
+        uses[root]++;
+    }
+    for (int id = static_cast<int>(nodes.size()) - 1; id >= 0; --id) {
+        if (uses[id] > 0 && nodes[id].lhs >= 0) {
+            uses[nodes[id].lhs]++;
+            if (nodes[id].rhs >= 0) {
+                uses[nodes[id].rhs]++;
+            }
+        }
+    }
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        const Node& node = nodes[id];
+        if (node.rhs >= 0) {
+            int a = need[node.lhs];
+            int b = need[node.rhs];
+            need[id] = a == b ? a + 1 : isCommutative(node.op) ? std::max(a, b) : std::max(a, b + 1);
+        } else if (node.lhs >= 0) {
+            need[id] = need[node.lhs];
+        }
+    }
+
+    for (size_t f = 0; f < roots.size(); ++f) {
+        emitNode(roots[f]);
+        code.push_back({OpCode::Output, static_cast<uint32_t>(f)});
+    }
+
+    size_t depth = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::Constant:
+            case OpCode::Variable:
+            case OpCode::Load: depth++; break;
+            case OpCode::Negate:
+            case OpCode::Store: break;
+            case OpCode::Output: depth--; break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide: depth--; break;
+            default: depth -= functionArity(instruction.op) - 1; break;
+        }
+        max_depth = std::max(max_depth, depth);
+    }
+    if (max_depth > CompiledExpression::MAX_DEPTH) {
+        throw std::invalid_argument("Formulas nest too deeply");
+    }
+
+    nodes.clear();
+    node_ids.clear();
+    uses.clear();
+    need.clear();
+    temp.clear();
+}
+
+inline void FormulaBatch::emitNode(int id) {
+    const Node& node = nodes[id];
+    if (temp[id] >= 0) {
+        code.push_back({OpCode::Load, static_cast<uint32_t>(temp[id])});
+        if (--uses[id] == 0) {
+            free_temps.push_back(static_cast<uint32_t>(temp[id]));
+        }
+        return;
+    }
+    if (node.op == OpCode::Constant) {
+        constants.push_back(node.value);
+        code.push_back({OpCode::Constant, static_cast<uint32_t>(constants.size() - 1)});
+        return;
+    }
+    if (node.op == OpCode::Variable) {
+        code.push_back({OpCode::Variable, node.operand});
+        return;
+    }
+
+    if (node.rhs < 0) {
+        emitNode(node.lhs);
+    } else if (isCommutative(node.op) && need[node.rhs] > need[node.lhs]) {
+        emitNode(node.rhs);
+        emitNode(node.lhs);
+    } else {
+        emitNode(node.lhs);
+        emitNode(node.rhs);
+    }
+    code.push_back({node.op, 0});
+
+    if (--uses[id] > 0) {
+        if (free_temps.empty()) {
+            free_temps.push_back(static_cast<uint32_t>(temps.size()));
+            temps.push_back(0);
+        }
+        temp[id] = static_cast<int>(free_temps.back());
+        free_temps.pop_back();
+        code.push_back({OpCode::Store, static_cast<uint32_t>(temp[id])});
+    }
+}
+
+inline void FormulaBatch::evaluate(const double* row, double* out) {
+    double stack[CompiledExpression::MAX_DEPTH];
+    double* top = stack;  // one past the top element
+    double* temp_values = temps.data();
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::Constant: *top++ = constants[instruction.operand]; break;
+            case OpCode::Variable: *top++ = row[instruction.operand]; break;
+            case OpCode::Add: top--; top[-1] += top[0]; break;
+            case OpCode::Subtract: top--; top[-1] -= top[0]; break;
+            case OpCode::Multiply: top--; top[-1] *= top[0]; break;
+            case OpCode::Divide: top--; top[-1] = divide(top[-1], top[0]); break;
+            case OpCode::Negate: top[-1] = -top[-1]; break;
+            case OpCode::Sqrt: top[-1] = std::sqrt(top[-1]); break;
+            case OpCode::Abs: top[-1] = std::fabs(top[-1]); break;
+            case OpCode::Exp: top[-1] = std::exp(top[-1]); break;
+            case OpCode::Log: top[-1] = std::log(top[-1]); break;
+            case OpCode::Floor: top[-1] = std::floor(top[-1]); break;
+            case OpCode::Ceil: top[-1] = std::ceil(top[-1]); break;
+            case OpCode::Min: top--; top[-1] = std::fmin(top[-1], top[0]); break;
+            case OpCode::Max: top--; top[-1] = std::fmax(top[-1], top[0]); break;
+            case OpCode::Pow: top--; top[-1] = std::pow(top[-1], top[0]); break;
+            case OpCode::Load: *top++ = temp_values[instruction.operand]; break;
+            case OpCode::Store: temp_values[instruction.operand] = top[-1]; break;
+            case OpCode::Output: out[instruction.operand] = *--top; break;
+        }
+    }
+}
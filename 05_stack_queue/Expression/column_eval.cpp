@@ -0,0 +1,113 @@
+// g++ -O2 -std=c++17 -mavx2 column_eval.cpp -o column_eval
+//
+//   ./column_eval [rows]
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ColumnEvaluator.hpp"
+#include "Expression.hpp"
+using namespace std;
+
+// The input is this many rows over and over (40 MB of doubles, does not fit
+// in cache).
+const size_t BASE = size_t(1) << 20;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+struct Result {
+    double sum = 0;
+    uint64_t nans = 0;
+
+    void add(double value) {
+        if (std::isnan(value)) {
+            nans++;
+        } else {
+            sum += value;
+        }
+    }
+};
+
+void report(const string& name, double seconds, uint64_t rows, const Result& result, const Result& expected,
+            double tolerance) {
+    bool same = result.nans == expected.nans && fabs(result.sum - expected.sum) <= tolerance * fabs(expected.sum);
+    cout << "    " << name << rows / seconds / 1e6 << " M rows/s, " << seconds / rows * 1e9 << " ns/row"
+         << (same ? "" : "  MISMATCH") << "\n";
+}
+
+template <typename T>
+Result columnar(ColumnEvaluator<T>& evaluator, const vector<vector<T>>& columns, uint64_t rows) {
+    vector<const T*> pointers;
+    for (const vector<T>& column : columns) {
+        pointers.push_back(column.data());
+    }
+    vector<T> out(BASE);
+    Result result;
+    for (uint64_t done = 0; done < rows; done += BASE) {
+        evaluator.evaluate(pointers.data(), BASE, out.data());
+        for (T value : out) {
+            result.add(value);
+        }
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint64_t requested = argc > 1 ? stoull(argv[1]) : 100000000;
+    uint64_t rows = (requested + BASE - 1) / BASE * BASE;
+
+    const vector<string> names = {"price", "quantity", "discount", "tax_rate", "shipping"};
+    mt19937_64 rng(73);
+    uniform_real_distribution<double> uniform(0, 1);
+    vector<vector<double>> columns(names.size(), vector<double>(BASE));
+    for (size_t r = 0; r < BASE; ++r) {
+        columns[0][r] = 1 + 99 * uniform(rng);
+        columns[1][r] = floor(1 + 20 * uniform(rng));
+        columns[2][r] = 10 * uniform(rng);
+        columns[3][r] = 0.25 * uniform(rng);
+        columns[4][r] = 10 * uniform(rng);
+    }
+    vector<vector<float>> float_columns;
+    for (const vector<double>& column : columns) {
+        float_columns.emplace_back(column.begin(), column.end());
+    }
+    // The same values row by row, for evaluate().
+    vector<double> row_major(BASE * names.size());
+    for (size_t r = 0; r < BASE; ++r) {
+        for (size_t v = 0; v < names.size(); ++v) {
+            row_major[r * names.size() + v] = columns[v][r];
+        }
+    }
+
+    // The second formula divides by zero in 1 row out of 20.
+    for (const string formula : {"(price * quantity - discount) / (1 + tax_rate) + max(shipping, 5.5)",
+                                 "sqrt(price) * quantity / (quantity - 3) - abs(discount - shipping)"}) {
+        CompiledExpression expression(formula, names);
+        cout << formula << "\n  " << rows << " rows:\n";
+
+        auto start = chrono::steady_clock::now();
+        Result expected;
+        for (uint64_t i = 0; i < rows; ++i) {
+            expected.add(expression.evaluate(&row_major[(i & (BASE - 1)) * names.size()]));
+        }
+        report("row at a time       ", secondsSince(start), rows, expected, expected, 0);
+
+        ColumnEvaluator<double> evaluator(expression);
+        start = chrono::steady_clock::now();
+        Result result = columnar(evaluator, columns, rows);
+        report("columns, double     ", secondsSince(start), rows, result, expected, 0);
+
+        ColumnEvaluator<float> float_evaluator(expression);
+        start = chrono::steady_clock::now();
+        result = columnar(float_evaluator, float_columns, rows);
+        report("columns, float      ", secondsSince(start), rows, result, expected, 1e-4);
+        cout << "    " << expected.nans << " NaN results\n";
+    }
+    return 0;
+}
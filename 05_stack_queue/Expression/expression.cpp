@@ -0,0 +1,86 @@
+// g++ -O2 -std=c++17 expression.cpp -o expression
+//
+//   ./expression [evaluations]
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Expression.hpp"
+using namespace std;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    uint64_t evaluations = argc > 1 ? stoull(argv[1]) : 100000000;
+
+    const vector<string> names = {"price", "quantity", "discount", "tax_rate", "shipping"};
+    // 20 tokens.
+    const string formula = "(price * quantity - discount) / (1 + tax_rate) + max(shipping, 5.5)";
+    CompiledExpression expression(formula, names);
+    cout << formula << "\n  RPN: " << expression.toRpn(names) << " (stack depth " << expression.maxDepth()
+         << ")\n";
+
+    for (const string bad : {"2 * (price + 1", "price quantity", "max(price)", "1 / / 2", "sin(price)"}) {
+        try {
+            CompiledExpression(bad, names);
+        } catch (const invalid_argument& error) {
+            cout << "  \"" << bad << "\": " << error.what() << "\n";
+        }
+    }
+    cout << "  1 / (price - price) = " << CompiledExpression("1 / (price - price)", names).evaluate(vector<double>{3}.data())
+         << "\n";
+
+    // A million rows, cycled.
+    const size_t ROWS = 1 << 20;
+    mt19937_64 rng(71);
+    uniform_real_distribution<double> uniform(0, 1);
+    vector<double> rows(ROWS * names.size());
+    for (size_t r = 0; r < ROWS; ++r) {
+        double* row = &rows[r * names.size()];
+        row[0] = 1 + 99 * uniform(rng);
+        row[1] = floor(1 + 20 * uniform(rng));
+        row[2] = 10 * uniform(rng);
+        row[3] = 0.25 * uniform(rng);
+        row[4] = 10 * uniform(rng);
+    }
+
+    auto start = chrono::steady_clock::now();
+    double native_sum = 0;
+    for (uint64_t i = 0; i < evaluations; ++i) {
+        const double* row = &rows[(i & (ROWS - 1)) * names.size()];
+        native_sum += (row[0] * row[1] - row[2]) / (1 + row[3]) + fmax(row[4], 5.5);
+    }
+    double native_seconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    double compiled_sum = 0;
+    for (uint64_t i = 0; i < evaluations; ++i) {
+        compiled_sum += expression.evaluate(&rows[(i & (ROWS - 1)) * names.size()]);
+    }
+    double compiled_seconds = secondsSince(start);
+
+    // Parsing on every call is ~100x slower; a sample is enough.
+    uint64_t reparsed = min<uint64_t>(evaluations, 2000000);
+    start = chrono::steady_clock::now();
+    double reparse_sum = 0, reparse_check = 0;
+    for (uint64_t i = 0; i < reparsed; ++i) {
+        const double* row = &rows[(i & (ROWS - 1)) * names.size()];
+        reparse_sum += CompiledExpression(formula, names).evaluate(row);
+        reparse_check += expression.evaluate(row);
+    }
+    double reparse_seconds = secondsSince(start);
+
+    cout << evaluations << " evaluations:\n";
+    cout << "  native C++          " << native_seconds / evaluations * 1e9 << " ns/evaluation\n";
+    cout << "  compiled bytecode   " << compiled_seconds / evaluations * 1e9 << " ns/evaluation"
+         << (fabs(compiled_sum - native_sum) <= 1e-9 * fabs(native_sum) ? "" : "  MISMATCH") << "\n";
+    cout << "  parse every time    " << reparse_seconds / reparsed * 1e9 << " ns/evaluation (" << reparsed
+         << " sampled)" << (reparse_sum == reparse_check ? "" : "  MISMATCH") << "\n";
+    return 0;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Stack with O(1) getMin() / getMax() (task 5) that does not keep a copy of
+// the minimum next to every element.
+//
+// The sequence "minimum of the stack with i elements" is constant over long
+// runs - it only changes when a push brings a strictly better value. Only
+// the start of each run is stored: the position of the element that became
+// the new minimum (its value is read from the stack itself). Popping that
+// element ends its run and the previous one is current again. The same for
+// the maximum.
+//
+// Run starts at consecutive positions (monotone input: every push is a new
+// maximum) are stored once more run-length encoded, as a first and a last
+// position - see RunStarts. So monotone input costs O(1) extra memory,
+// random input about ln(n) entries, and the worst case (every push a new
+// minimum or maximum, alternating) one Index per element - against the two
+// full copies the min + max version of MinStack keeps.
+//
+// Index is the position type; the stack holds at most 2^(bits - 1) - 1
+// elements (the top bit is a flag).
+template <typename T, typename Compare = std::less<T>, typename Index = uint32_t>
+class MinMaxStack {
+public:
+    explicit MinMaxStack(Compare compare = Compare()) : compare(compare) {}
+
+    void push(const T& value) {
+        Index position = nextPosition();
+        // Compared before push_back: value may refer into values.
+        bool new_min = position == 0 || compare(value, values[min_runs.current()]);
+        bool new_max = position == 0 || compare(values[max_runs.current()], value);
+        values.push_back(value);
+        if (new_min) {
+            min_runs.push(position);
+        }
+        if (new_max) {
+            max_runs.push(position);
+        }
+    }
+
+    // Pushes n values (not from this stack); the runs are found in one pass
+    // with the current min / max kept in registers.
+    void pushBulk(const T* first, size_t n);
+
+    void pop() {
+        if (values.empty()) {
+            throw std::logic_error("Stack is empty");
+        }
+        Index position = static_cast<Index>(values.size() - 1);
+        min_runs.popIfStart(position);
+        max_runs.popIfStart(position);
+        values.pop_back();
+    }
+
+    const T& top() const {
+        checkNotEmpty();
+        return values.back();
+    }
+
+    const T& getMin() const {
+        checkNotEmpty();
+        return values[min_runs.current()];
+    }
+
+    const T& getMax() const {
+        checkNotEmpty();
+        return values[max_runs.current()];
+    }
+
+    size_t size() const { return values.size(); }
+    bool isEmpty() const { return values.empty(); }
+    // Stored entries for the minimum / maximum history.
+    size_t minEntries() const { return min_runs.entries.size(); }
+    size_t maxEntries() const { return max_runs.entries.size(); }
+
+    void reserve(size_t n) { values.reserve(n); }
+    // Heap bytes held (capacities, not sizes).
+    size_t memoryBytes() const {
+        return values.capacity() * sizeof(T) +
+               (min_runs.entries.capacity() + max_runs.entries.capacity()) * sizeof(Index);
+    }
+
+private:
+    static constexpr Index STREAK_END = Index(1) << (std::numeric_limits<Index>::digits - 1);
+    static constexpr Index POSITION = STREAK_END - 1;
+
+    // Positions where a run starts, ascending. A streak of consecutive
+    // starts a, a + 1, ..., b is stored as the two entries a, b | STREAK_END;
+    // a lone start as just a.
+    struct RunStarts {
+        std::vector<Index> entries;
+
+        Index current() const { return entries.back() & POSITION; }
+
+        void push(Index position) {
+            if (!entries.empty() && current() + 1 == position) {
+                if (entries.back() & STREAK_END) {
+                    entries.back() = position | STREAK_END;
+                } else {
+                    entries.push_back(position | STREAK_END);
+                }
+            } else {
+                entries.push_back(position);
+            }
+        }
+
+        void popIfStart(Index position) {
+            Index last = entries.back();
+            if ((last & POSITION) != position) {
+                return;
+            }
+            // A streak ending here shrinks by one, or back to its lone start.
+            if ((last & STREAK_END) && entries[entries.size() - 2] + 1 != position) {
+                entries.back() = (position - 1) | STREAK_END;
+            } else {
+                entries.pop_back();
+            }
+        }
+    };
+
+    std::vector<T> values;
+    RunStarts min_runs;
+    RunStarts max_runs;
+    Compare compare;
+
+    Index nextPosition() const {
+        if (values.size() >= POSITION) {
+            throw std::length_error("Stack is full for this Index type");
+        }
+        return static_cast<Index>(values.size());
+    }
+
+    void checkNotEmpty() const {
+        if (values.empty()) {
+            throw std::logic_error("Stack is empty");
+        }
+    }
+};
+
+template <typename T, typename Compare, typename Index>
+void MinMaxStack<T, Compare, Index>::pushBulk(const T* first, size_t n) {
+    if (n == 0) {
+        return;
+    }
+    if (values.size() + n > POSITION) {
+        throw std::length_error("Stack is full for this Index type");
+    }
+    if (values.empty()) {
+        push(*first++);
+        n--;
+    }
+    size_t start = values.size();
+    values.insert(values.end(), first, first + n);
+
+    T current_min = values[min_runs.current()];
+    T current_max = values[max_runs.current()];
+    for (size_t i = start; i < start + n; ++i) {
+        const T& value = values[i];
+        if (compare(value, current_min)) {
+            current_min = value;
+            min_runs.push(static_cast<Index>(i));
+        } else if (compare(current_max, value)) {
+            current_max = value;
+            max_runs.push(static_cast<Index>(i));
+        }
+    }
+}
@@ -0,0 +1,145 @@
+// g++ -O2 -std=c++17 min_max_stack.cpp -o min_max_stack
+//
+//   ./min_max_stack [pushes] [depth]
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "MinMaxStack.hpp"
+using namespace std;
+
+// Live and peak heap bytes, counted in the global operator new / delete.
+size_t live_bytes = 0, peak_bytes = 0;
+
+void* operator new(size_t size) {
+    void* p = malloc(size);
+    if (!p) {
+        throw bad_alloc();
+    }
+    live_bytes += malloc_usable_size(p);
+    peak_bytes = max(peak_bytes, live_bytes);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        live_bytes -= malloc_usable_size(p);
+        free(p);
+    }
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+// MinStack from task 5 with a max stack added the same way.
+class MinStack {
+private:
+    std::stack<int> st;
+    std::stack<int> min_st;
+    std::stack<int> max_st;
+public:
+    void push(int val) {
+        st.push(val);
+        min_st.push(min_st.empty() ? val : std::min(min_st.top(), val));
+        max_st.push(max_st.empty() ? val : std::max(max_st.top(), val));
+    }
+    void pop() {
+        st.pop();
+        min_st.pop();
+        max_st.pop();
+    }
+    bool isEmpty() const { return st.empty(); }
+    int getMin() const { return min_st.top(); }
+    int getMax() const { return max_st.top(); }
+};
+
+// Values for one round of pushes.
+void fill(vector<int>& values, const string& kind, mt19937_64& rng) {
+    size_t n = values.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (kind == "increasing") {
+            values[i] = static_cast<int>(i);
+        } else if (kind == "random") {
+            values[i] = static_cast<int>(rng() >> 33);
+        } else {
+            // Widening zigzag: every push is a new minimum or a new maximum.
+            values[i] = i % 2 ? static_cast<int>(i / 2 + 1) : -static_cast<int>(i / 2);
+        }
+    }
+}
+
+// Each round pushes `depth` values, then pops them all while reading min and
+// max. Returns a checksum of everything read.
+template <typename Push, typename Stack>
+int64_t rounds(Stack& stack, const vector<int>& values, uint64_t pushes, Push push) {
+    int64_t checksum = 0;
+    for (uint64_t done = 0; done < pushes; done += values.size()) {
+        push(stack, values);
+        while (!stack.isEmpty()) {
+            checksum += stack.getMin() - stack.getMax();
+            stack.pop();
+        }
+    }
+    return checksum;
+}
+
+template <typename Stack, typename Push>
+void measure(const string& name, const vector<int>& values, uint64_t pushes, int64_t& expected, Push push) {
+    size_t peak_before = peak_bytes = live_bytes;
+    auto start = chrono::steady_clock::now();
+    int64_t checksum;
+    {
+        Stack stack;
+        checksum = rounds(stack, values, pushes, push);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (expected == INT64_MIN) {
+        expected = checksum;
+    }
+    cout << "    " << name << seconds / pushes * 1e9 << " ns/push+pop, peak "
+         << double(peak_bytes - peak_before) / values.size() << " bytes/element"
+         << (checksum == expected ? "" : "  MISMATCH") << "\n";
+}
+
+int main(int argc, char** argv) {
+    uint64_t pushes = argc > 1 ? stoull(argv[1]) : 1000000000;
+    size_t depth = argc > 2 ? stoull(argv[2]) : 100000000;
+    cout << pushes << " pushes in rounds of " << depth << "\n";
+
+    mt19937_64 rng(67);
+    vector<int> values(depth);
+    for (const string kind : {"increasing", "random", "zigzag"}) {
+        fill(values, kind, rng);
+        cout << "  " << kind << ":\n";
+        int64_t expected = INT64_MIN;
+        measure<MinStack>("MinStack (3 x std::stack)  ", values, pushes, expected,
+                          [](MinStack& stack, const vector<int>& in) {
+                              for (int value : in) {
+                                  stack.push(value);
+                              }
+                          });
+        measure<MinMaxStack<int>>("MinMaxStack push           ", values, pushes, expected,
+                                  [](MinMaxStack<int>& stack, const vector<int>& in) {
+                                      for (int value : in) {
+                                          stack.push(value);
+                                      }
+                                  });
+        measure<MinMaxStack<int>>("MinMaxStack pushBulk       ", values, pushes, expected,
+                                  [](MinMaxStack<int>& stack, const vector<int>& in) {
+                                      stack.pushBulk(in.data(), in.size());
+                                  });
+        MinMaxStack<int> probe;
+        probe.pushBulk(values.data(), values.size());
+        cout << "    " << probe.minEntries() << " min / " << probe.maxEntries() << " max history entries, "
+             << double(probe.memoryBytes()) / values.size() << " bytes/element held at full depth\n";
+    }
+    return 0;
+}
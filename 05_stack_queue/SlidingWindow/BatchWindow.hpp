@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Sliding-window min / max / sum over whole arrays at once: out[i] is the
+// aggregate of in[i .. i + window - 1], for every i with a full window
+// (n - window + 1 outputs). For streams, call it per chunk with the last
+// window - 1 values of the previous chunk in front.
+//
+//   min / max, window <= 256: doubling. After pass k every slot holds the
+//     extreme of 2^k values starting there; two overlapping spans cover any
+//     window. log2(window) vectorised passes over a cache-sized tile.
+//   min / max, larger windows: van Herk / Gil-Werman. Cut the input in
+//     blocks of `window`; every window is a suffix of one block plus a
+//     prefix of the next, so one backward and one forward scan per block
+//     give every answer - 3 comparisons per element whatever the window.
+//   sum: out[i] = out[i - 1] + (in[i + window - 1] - in[i - 1]), i.e. a
+//     prefix sum of differences, done 4 lanes at a time with an in-register
+//     scan.
+//
+// The scratch buffer is allocated in the constructor; the calls do not
+// allocate.
+class BatchWindow {
+public:
+    explicit BatchWindow(size_t window);
+
+    size_t window() const { return width; }
+
+    // Each returns the number of outputs written, n - window + 1 (0 if n < window).
+    size_t windowMin(const int32_t* in, size_t n, int32_t* out) { return extreme<false>(in, n, out); }
+    size_t windowMax(const int32_t* in, size_t n, int32_t* out) { return extreme<true>(in, n, out); }
+    size_t windowSum(const int32_t* in, size_t n, int64_t* out);
+
+private:
+    static constexpr size_t SMALL_WINDOW = 256;
+
+    size_t width;
+    size_t tile;  // outputs per doubling tile
+    std::vector<int32_t> scratch;
+
+    template <bool IsMax>
+    static int32_t better(int32_t a, int32_t b) { return IsMax ? std::max(a, b) : std::min(a, b); }
+
+    // dst[i] = better(a[i], b[i]); dst may be a (b ahead of a is read first).
+    template <bool IsMax>
+    static void combine(const int32_t* a, const int32_t* b, int32_t* dst, size_t n);
+
+    template <bool IsMax>
+    size_t extreme(const int32_t* in, size_t n, int32_t* out);
+    template <bool IsMax>
+    void doubling(const int32_t* in, size_t outputs, int32_t* out);
+    template <bool IsMax>
+    void vanHerk(const int32_t* in, size_t outputs, int32_t* out);
+};
+
+inline BatchWindow::BatchWindow(size_t window) : width(window), tile(std::max<size_t>(4096, 8 * window)) {
+    if (window == 0) {
+        throw std::invalid_argument("Window must be positive");
+    }
+    scratch.resize(window <= SMALL_WINDOW ? tile + window : window);
+}
+
+template <bool IsMax>
+void BatchWindow::combine(const int32_t* a, const int32_t* b, int32_t* dst, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i r = IsMax ? _mm256_max_epi32(x, y) : _mm256_min_epi32(x, y);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = better<IsMax>(a[i], b[i]);
+    }
+}
+
+template <bool IsMax>
+size_t BatchWindow::extreme(const int32_t* in, size_t n, int32_t* out) {
+    if (n < width) {
+        return 0;
+    }
+    size_t outputs = n - width + 1;
+    if (width == 1) {
+        std::copy(in, in + n, out);
+    } else if (width <= SMALL_WINDOW) {
+        doubling<IsMax>(in, outputs, out);
+    } else {
+        vanHerk<IsMax>(in, outputs, out);
+    }
+    return outputs;
+}
+
+template <bool IsMax>
+void BatchWindow::doubling(const int32_t* in, size_t outputs, int32_t* out) {
+    int32_t* buffer = scratch.data();
+    for (size_t base = 0; base < outputs; base += tile) {
+        size_t count = std::min(tile, outputs - base);
+        // Spans of 2 straight from the input, then doubled in place.
+        size_t length = count + width - 2;
+        combine<IsMax>(in + base, in + base + 1, buffer, length);
+        size_t span = 2;
+        while (span * 2 <= width) {
+            length -= span;
+            combine<IsMax>(buffer, buffer + span, buffer, length);
+            span *= 2;
+        }
+        // span <= width < 2 * span: two overlapping spans.
+        combine<IsMax>(buffer, buffer + (width - span), out + base, count);
+    }
+}
+
+template <bool IsMax>
+void BatchWindow::vanHerk(const int32_t* in, size_t outputs, int32_t* out) {
+    int32_t* suffix = scratch.data();
+    for (size_t start = 0; start < outputs; start += width) {
+        // Suffix extremes of the block [start, start + width).
+        const int32_t* block = in + start;
+        suffix[width - 1] = block[width - 1];
+        for (size_t k = width - 1; k-- > 0;) {
+            suffix[k] = better<IsMax>(block[k], suffix[k + 1]);
+        }
+        // Window starting at start + k: suffix[k] plus the first k values
+        // of the next block.
+        out[start] = suffix[0];
+        size_t count = std::min(width, outputs - start);
+        int32_t prefix = IsMax ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int32_t>::max();
+        for (size_t k = 1; k < count; ++k) {
+            prefix = better<IsMax>(prefix, block[width + k - 1]);
+            out[start + k] = better<IsMax>(suffix[k], prefix);
+        }
+    }
+}
+
+inline size_t BatchWindow::windowSum(const int32_t* in, size_t n, int64_t* out) {
+    if (n < width) {
+        return 0;
+    }
+    size_t outputs = n - width + 1;
+    int64_t total = 0;
+    for (size_t k = 0; k < width; ++k) {
+        total += in[k];
+    }
+    out[0] = total;
+    const int32_t* entering = in + width;  // entering[i - 1] joins window i
+    const int32_t* leaving = in;           // leaving[i - 1] leaves window i
+    size_t i = 1;
+#ifdef __AVX2__
+    // carry holds out[i - 1] in all lanes. Each step scans 4 differences in
+    // the register; the only dependency between steps is one add.
+    __m256i carry = _mm256_set1_epi64x(total);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 4 <= outputs; i += 4) {
+        __m128i enter = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entering + i - 1));
+        __m128i leave = _mm_loadu_si128(reinterpret_cast<const __m128i*>(leaving + i - 1));
+        __m256i d = _mm256_sub_epi64(_mm256_cvtepi32_epi64(enter), _mm256_cvtepi32_epi64(leave));
+        // d += d shifted up one lane, then two lanes.
+        d = _mm256_add_epi64(d, _mm256_blend_epi32(_mm256_permute4x64_epi64(d, 0x90), zero, 0x03));
+        d = _mm256_add_epi64(d, _mm256_blend_epi32(_mm256_permute4x64_epi64(d, 0x40), zero, 0x0f));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi64(carry, d));
+        carry = _mm256_add_epi64(carry, _mm256_permute4x64_epi64(d, 0xff));
+    }
+    if (i > 1) {
+        total = out[i - 1];
+    }
+#endif
+    for (; i < outputs; ++i) {
+        total += static_cast<int64_t>(entering[i - 1]) - leaving[i - 1];
+        out[i] = total;
+    }
+    return outputs;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+// Minimum (or, with std::greater, maximum) of the last `window` values of a
+// stream, O(1) amortized per value.
+//
+// Same idea as the stack in task 6 (canSeePersonsCount): a value that is
+// newer and not worse than an older one hides it for good, so the older one
+// is popped and never looked at again. What remains is monotonic from the
+// oldest (the answer) to the newest. Unlike a stack it also loses elements
+// at the old end when they leave the window - a deque.
+//
+// The deque is a ring allocated once in the constructor (it never holds more
+// than window + 1 entries - briefly, before the oldest expires), so push
+// never allocates.
+template <typename T, typename Compare = std::less<T>>
+class MonotonicWindow {
+public:
+    explicit MonotonicWindow(size_t window, Compare compare = Compare());
+
+    // Slides the window by one value.
+    void push(const T& value) {
+        // Pop everything the new value hides (ties too: the new one lives longer).
+        while (tail != head && !compare(entries[(tail - 1) & mask].value, value)) {
+            tail--;
+        }
+        entries[tail & mask] = {value, pushed};
+        tail++;
+        pushed++;
+        // At most one entry can leave the window per push.
+        if (entries[head & mask].position + window < pushed) {
+            head++;
+        }
+    }
+
+    // The best value in the window (minimum for std::less).
+    const T& best() const {
+        if (head == tail) {
+            throw std::logic_error("Window is empty");
+        }
+        return entries[head & mask].value;
+    }
+
+    // Values in the window (fewer than `window` until it fills up).
+    size_t size() const { return pushed < window ? pushed : window; }
+    bool isFull() const { return pushed >= window; }
+    // Entries actually kept (the monotonic chain).
+    size_t chainLength() const { return tail - head; }
+
+    void clear() { head = tail = pushed = 0; }
+
+private:
+    struct Entry {
+        T value;
+        uint64_t position;  // index in the stream
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+    size_t head = 0;  // ring indices, only taken modulo the capacity
+    size_t tail = 0;
+    uint64_t pushed = 0;
+    size_t window;
+    Compare compare;
+};
+
+template <typename T, typename Compare>
+MonotonicWindow<T, Compare>::MonotonicWindow(size_t window, Compare compare)
+    : window(window), compare(compare) {
+    if (window == 0) {
+        throw std::invalid_argument("Window must be positive");
+    }
+    size_t capacity = 1;
+    while (capacity < window + 1) {
+        capacity <<= 1;
+    }
+    entries.reset(new Entry[capacity]);
+    mask = capacity - 1;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+// Aggregate of the last `window` values of a stream for any associative
+// operation - sum, gcd, min, matrix product, ... - O(1) amortized per value.
+//
+// The queue-from-two-stacks trick with an aggregate on each stack (the
+// MinStack of task 5 keeps the running min next to every element in the
+// same way). New values go onto the back stack, which only keeps its total.
+// The front stack holds the oldest values, each with the aggregate from it
+// to the end of the front stack. When the front stack runs out, the whole
+// back stack is flipped over in one pass (every value is flipped once).
+//
+// Both stacks live in one ring of `window` slots: the front stack is the
+// first front_count elements from head, the back stack the rest. The
+// aggregate is always front (older) op back (newer), so the operation does
+// not have to be commutative.
+//
+// Op provides T operator()(const T&, const T&) and T identity().
+template <typename T, typename Op>
+class TwoStackWindow {
+public:
+    explicit TwoStackWindow(size_t window, Op op = Op());
+
+    // Slides the window by one value.
+    void push(const T& value) {
+        if (count == window) {
+            popOldest();
+        }
+        values[(head + count) & mask] = value;
+        count++;
+        back_total = op(back_total, value);
+    }
+
+    T aggregate() const {
+        return front_count ? op(front_totals[head], back_total) : back_total;
+    }
+
+    size_t size() const { return count; }
+    bool isFull() const { return count == window; }
+
+    void clear() {
+        head = count = front_count = 0;
+        back_total = op.identity();
+    }
+
+private:
+    std::unique_ptr<T[]> values;
+    std::unique_ptr<T[]> front_totals;  // valid for the front stack only
+    size_t mask;
+    size_t head = 0;
+    size_t count = 0;
+    size_t front_count = 0;
+    size_t window;
+    T back_total;
+    Op op;
+
+    void popOldest() {
+        if (front_count == 0) {
+            flip();
+        }
+        head = (head + 1) & mask;
+        count--;
+        front_count--;
+    }
+
+    // Moves the whole back stack to the front stack.
+    void flip() {
+        T total = op.identity();
+        for (size_t i = count; i-- > 0;) {
+            size_t slot = (head + i) & mask;
+            total = op(values[slot], total);
+            front_totals[slot] = total;
+        }
+        front_count = count;
+        back_total = op.identity();
+    }
+};
+
+template <typename T, typename Op>
+TwoStackWindow<T, Op>::TwoStackWindow(size_t window, Op op) : window(window), op(op) {
+    if (window == 0) {
+        throw std::invalid_argument("Window must be positive");
+    }
+    size_t capacity = 1;
+    while (capacity < window) {
+        capacity <<= 1;
+    }
+    values.reset(new T[capacity]);
+    front_totals.reset(new T[capacity]);
+    mask = capacity - 1;
+    back_total = this->op.identity();
+}
+
+template <typename T>
+struct SumOp {
+    T operator()(const T& a, const T& b) const { return a + b; }
+    T identity() const { return T(); }
+};
+
+template <typename T>
+struct GcdOp {
+    T operator()(const T& a, const T& b) const { return std::gcd(a, b); }
+    T identity() const { return T(); }
+};
@@ -0,0 +1,152 @@
+// g++ -O2 -std=c++17 -mavx2 sliding_window.cpp -o sliding_window
+//
+//   ./sliding_window [values]
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BatchWindow.hpp"
+#include "MonotonicWindow.hpp"
+#include "TwoStackWindow.hpp"
+using namespace std;
+
+// The stream is this buffer over and over (64 MB, does not fit in cache).
+const size_t BASE = size_t(1) << 24;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void report(const string& name, double seconds, uint64_t values, int64_t checksum, int64_t expected) {
+    cout << "    " << name << seconds / values * 1e9 << " ns/value" << (checksum == expected ? "" : "  MISMATCH")
+         << "\n";
+}
+
+// Ad hoc monotonic deque on std::deque, the way task 6 uses std::stack.
+int64_t stdDequeMin(const vector<int32_t>& base, uint64_t values, size_t window) {
+    deque<pair<int32_t, uint64_t>> chain;
+    int64_t checksum = 0;
+    for (uint64_t i = 0; i < values; ++i) {
+        int32_t value = base[i & (BASE - 1)];
+        while (!chain.empty() && chain.back().first >= value) {
+            chain.pop_back();
+        }
+        chain.push_back({value, i});
+        if (chain.front().second + window <= i) {
+            chain.pop_front();
+        }
+        if (i + 1 >= window) {
+            checksum += chain.front().first;
+        }
+    }
+    return checksum;
+}
+
+template <typename Window>
+int64_t streamBest(const vector<int32_t>& base, uint64_t values, Window& window) {
+    int64_t checksum = 0;
+    for (uint64_t i = 0; i < values; ++i) {
+        window.push(base[i & (BASE - 1)]);
+        if (window.isFull()) {
+            checksum += window.best();
+        }
+    }
+    return checksum;
+}
+
+int64_t streamSum(const vector<int32_t>& base, uint64_t values, TwoStackWindow<int64_t, SumOp<int64_t>>& window) {
+    int64_t checksum = 0;
+    for (uint64_t i = 0; i < values; ++i) {
+        window.push(base[i & (BASE - 1)]);
+        if (window.isFull()) {
+            checksum += window.aggregate();
+        }
+    }
+    return checksum;
+}
+
+// Feeds the stream to a BatchWindow kernel in chunks; the last window - 1
+// values of each chunk are kept in front of the next one.
+template <typename Out, typename Kernel>
+int64_t batched(const vector<int32_t>& base, uint64_t values, size_t window, size_t chunk, Kernel kernel) {
+    vector<int32_t> stage(window - 1 + chunk);
+    vector<Out> out(stage.size());
+    size_t have = 0;
+    int64_t checksum = 0;
+    for (uint64_t done = 0; done < values; done += chunk) {
+        memcpy(stage.data() + have, base.data() + (done & (BASE - 1)), chunk * sizeof(int32_t));
+        have += chunk;
+        size_t outputs = kernel(stage.data(), have, out.data());
+        for (size_t i = 0; i < outputs; ++i) {
+            checksum += out[i];
+        }
+        size_t keep = min(have, window - 1);
+        memmove(stage.data(), stage.data() + have - keep, keep * sizeof(int32_t));
+        have = keep;
+    }
+    return checksum;
+}
+
+int main(int argc, char** argv) {
+    uint64_t requested = argc > 1 ? stoull(argv[1]) : 1000000000;
+
+    // Latency-like metric: mostly small, occasional spikes.
+    mt19937_64 rng(61);
+    vector<int32_t> base(BASE);
+    for (int32_t& value : base) {
+        value = static_cast<int32_t>(rng() % 1000);
+        if (rng() % 100 == 0) {
+            value += static_cast<int32_t>(rng() % 100000);
+        }
+    }
+
+    for (size_t window : {size_t(16), size_t(256), size_t(4096), size_t(65536), size_t(1) << 20}) {
+        size_t chunk = max(size_t(1) << 15, 2 * window);
+        uint64_t values = (requested + chunk - 1) / chunk * chunk;
+        cout << "window " << window << ", " << values << " values:\n";
+
+        auto start = chrono::steady_clock::now();
+        MonotonicWindow<int32_t> min_window(window);
+        int64_t expected = streamBest(base, values, min_window);
+        cout << "  min\n";
+        report("MonotonicWindow     ", secondsSince(start), values, expected, expected);
+        start = chrono::steady_clock::now();
+        int64_t checksum = stdDequeMin(base, values, window);
+        report("std::deque chain    ", secondsSince(start), values, checksum, expected);
+        BatchWindow batch(window);
+        start = chrono::steady_clock::now();
+        checksum = batched<int32_t>(base, values, window, chunk, [&](const int32_t* in, size_t n, int32_t* out) {
+            return batch.windowMin(in, n, out);
+        });
+        report("BatchWindow         ", secondsSince(start), values, checksum, expected);
+
+        cout << "  max\n";
+        start = chrono::steady_clock::now();
+        MonotonicWindow<int32_t, greater<int32_t>> max_window(window);
+        expected = streamBest(base, values, max_window);
+        report("MonotonicWindow     ", secondsSince(start), values, expected, expected);
+        start = chrono::steady_clock::now();
+        checksum = batched<int32_t>(base, values, window, chunk, [&](const int32_t* in, size_t n, int32_t* out) {
+            return batch.windowMax(in, n, out);
+        });
+        report("BatchWindow         ", secondsSince(start), values, checksum, expected);
+
+        cout << "  sum\n";
+        start = chrono::steady_clock::now();
+        TwoStackWindow<int64_t, SumOp<int64_t>> sum_window(window);
+        expected = streamSum(base, values, sum_window);
+        report("TwoStackWindow      ", secondsSince(start), values, expected, expected);
+        start = chrono::steady_clock::now();
+        checksum = batched<int64_t>(base, values, window, chunk, [&](const int32_t* in, size_t n, int64_t* out) {
+            return batch.windowSum(in, n, out);
+        });
+        report("BatchWindow         ", secondsSince(start), values, checksum, expected);
+    }
+    return 0;
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "WaitPolicy.hpp"
+
+// Bounded queue for any number of producers and consumers (Vyukov's
+// sequence-numbered ring). Every slot carries a sequence number that says
+// whose turn it is:
+//     sequence == position          free, the producer of `position` may write
+//     sequence == position + 1      full, the consumer of `position` may read
+//     sequence == position + size   free again for the next lap
+// A thread claims a position with one compare-and-swap on enqueue_pos /
+// dequeue_pos and then owns the slot - there is no lock and a stalled thread
+// only blocks its own slot.
+//
+// Batches claim k consecutive positions with a single compare-and-swap, so
+// the contended counter is touched once per batch instead of once per
+// element. The claim is bounded by the other counter (a producer only claims
+// slots whose previous element a consumer has already claimed), so the wait
+// for each claimed slot is short - the owner is already inside its
+// operation. This gives up strict lock-freedom for the batch calls: a
+// preempted thread in the middle of a batch delays the thread that follows
+// it in the same slots.
+//
+// T must be default constructible and move assignable.
+template <typename T, typename Wait = SpinWait>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity);
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    template <typename U>
+    bool tryPush(U&& element);
+    template <typename U>
+    void push(U&& element);
+    // Pushes up to n, returns how many.
+    size_t tryPushBatch(const T* elements, size_t n);
+    // Pushes all n, waiting for room as needed.
+    void pushBatch(const T* elements, size_t n);
+
+    bool tryPop(T& out);
+    T pop();
+    // Pops up to max, returns how many (0 if empty).
+    size_t tryPopBatch(T* out, size_t max);
+    // Waits for at least one element, then pops up to max (0 at once if max
+    // is 0).
+    size_t popBatch(T* out, size_t max);
+
+    // Approximate when called during concurrent use.
+    size_t size() const;
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> enqueue_pos{0};
+    alignas(CACHE_LINE) std::atomic<size_t> dequeue_pos{0};
+    alignas(CACHE_LINE) Wait not_full;
+    alignas(CACHE_LINE) Wait not_empty;
+
+    // Claims up to n positions on `claimed`, bounded by `limit(position)`.
+    template <typename Limit>
+    static size_t claim(std::atomic<size_t>& claimed, size_t n, size_t& position, Limit limit);
+
+    // Wait conditions: the next slot to claim is actually free / written,
+    // not just counted as such (its owner may still be inside its call).
+    bool hasRoom() const {
+        size_t position = enqueue_pos.load(std::memory_order_relaxed);
+        size_t sequence = cells[position & mask].sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(sequence - position) >= 0;
+    }
+    bool hasData() const {
+        size_t position = dequeue_pos.load(std::memory_order_relaxed);
+        size_t sequence = cells[position & mask].sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(sequence - position - 1) >= 0;
+    }
+};
+
+template <typename T, typename Wait>
+MpmcQueue<T, Wait>::MpmcQueue(size_t capacity) {
+    if (capacity < 2) {
+        throw std::invalid_argument("Capacity must be at least 2");
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    cells.reset(new Cell[rounded]);
+    mask = rounded - 1;
+    for (size_t i = 0; i < rounded; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Wait>
+template <typename U>
+bool MpmcQueue<T, Wait>::tryPush(U&& element) {
+    size_t position = enqueue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[position & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (enqueue_pos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;  // the slot still holds last lap's element: full
+        } else {
+            position = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::forward<U>(element);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    not_empty.notify();
+    return true;
+}
+
+template <typename T, typename Wait>
+template <typename U>
+void MpmcQueue<T, Wait>::push(U&& element) {
+    while (!tryPush(std::forward<U>(element))) {
+        not_full.wait([this] { return hasRoom(); });
+    }
+}
+
+template <typename T, typename Wait>
+bool MpmcQueue<T, Wait>::tryPop(T& out) {
+    size_t position = dequeue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[position & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (difference == 0) {
+            if (dequeue_pos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;  // not written yet: empty
+        } else {
+            position = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    out = std::move(cell->value);
+    cell->sequence.store(position + mask + 1, std::memory_order_release);
+    not_full.notify();
+    return true;
+}
+
+template <typename T, typename Wait>
+T MpmcQueue<T, Wait>::pop() {
+    T out;
+    while (!tryPop(out)) {
+        not_empty.wait([this] { return hasData(); });
+    }
+    return out;
+}
+
+template <typename T, typename Wait>
+template <typename Limit>
+size_t MpmcQueue<T, Wait>::claim(std::atomic<size_t>& claimed, size_t n, size_t& position, Limit limit) {
+    position = claimed.load(std::memory_order_relaxed);
+    for (;;) {
+        intptr_t available = limit(position);
+        if (available <= 0) {
+            if (available < 0) {
+                // position is stale (older than the limit's counter): retry.
+                position = claimed.load(std::memory_order_relaxed);
+                continue;
+            }
+            return 0;
+        }
+        size_t k = std::min(n, static_cast<size_t>(available));
+        if (claimed.compare_exchange_weak(position, position + k, std::memory_order_relaxed)) {
+            return k;
+        }
+    }
+}
+
+template <typename T, typename Wait>
+size_t MpmcQueue<T, Wait>::tryPushBatch(const T* elements, size_t n) {
+    size_t position;
+    size_t k = claim(enqueue_pos, n, position, [this](size_t p) {
+        return static_cast<intptr_t>(dequeue_pos.load(std::memory_order_acquire) + capacity() - p);
+    });
+    for (size_t i = 0; i < k; ++i) {
+        Cell& cell = cells[(position + i) & mask];
+        spinUntil([&] { return cell.sequence.load(std::memory_order_acquire) == position + i; });
+        cell.value = elements[i];
+        cell.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    if (k > 0) {
+        not_empty.notify();
+    }
+    return k;
+}
+
+template <typename T, typename Wait>
+void MpmcQueue<T, Wait>::pushBatch(const T* elements, size_t n) {
+    while (n > 0) {
+        size_t pushed = tryPushBatch(elements, n);
+        elements += pushed;
+        n -= pushed;
+        if (pushed == 0) {
+            not_full.wait([this] { return hasRoom(); });
+        }
+    }
+}
+
+template <typename T, typename Wait>
+size_t MpmcQueue<T, Wait>::tryPopBatch(T* out, size_t max) {
+    size_t position;
+    size_t k = claim(dequeue_pos, max, position, [this](size_t p) {
+        return static_cast<intptr_t>(enqueue_pos.load(std::memory_order_acquire) - p);
+    });
+    for (size_t i = 0; i < k; ++i) {
+        Cell& cell = cells[(position + i) & mask];
+        spinUntil([&] { return cell.sequence.load(std::memory_order_acquire) == position + i + 1; });
+        out[i] = std::move(cell.value);
+        cell.sequence.store(position + i + mask + 1, std::memory_order_release);
+    }
+    if (k > 0) {
+        not_full.notify();
+    }
+    return k;
+}
+
+template <typename T, typename Wait>
+size_t MpmcQueue<T, Wait>::popBatch(T* out, size_t max) {
+    if (max == 0) {
+        return 0;
+    }
+    size_t n;
+    while ((n = tryPopBatch(out, max)) == 0) {
+        not_empty.wait([this] { return hasData(); });
+    }
+    return n;
+}
+
+template <typename T, typename Wait>
+size_t MpmcQueue<T, Wait>::size() const {
+    size_t dequeued = dequeue_pos.load(std::memory_order_acquire);
+    size_t enqueued = enqueue_pos.load(std::memory_order_acquire);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "WaitPolicy.hpp"
+
+// Bounded queue for exactly one producer thread and one consumer thread
+// (Lamport's ring). Only the producer writes tail and only the consumer
+// writes head, so no compare-and-swap is needed - a release store publishes
+// the slots, an acquire load on the other side sees them.
+//
+// Each side keeps a private copy of the other side's index and re-reads the
+// shared one only when the copy says full / empty. In steady state the
+// cache line of the other index is not touched at all. The two sides live
+// on separate cache lines so they do not invalidate each other.
+//
+// T must be default constructible and move assignable (the slots are a
+// plain array).
+template <typename T, typename Wait = SpinWait>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity);
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side.
+    template <typename U>
+    bool tryPush(U&& element);
+    template <typename U>
+    void push(U&& element);
+    // Pushes as many as fit (at most n), returns how many.
+    size_t tryPushBatch(const T* elements, size_t n);
+    // Pushes all n, waiting for room as needed.
+    void pushBatch(const T* elements, size_t n);
+
+    // Consumer side.
+    bool tryPop(T& out);
+    T pop();
+    // Pops up to max elements, returns how many (0 if empty).
+    size_t tryPopBatch(T* out, size_t max);
+    // Waits for at least one element, then pops up to max (0 at once if max
+    // is 0).
+    size_t popBatch(T* out, size_t max);
+
+    // Approximate when called during concurrent use.
+    size_t size() const;
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail{0};  // written by the producer
+    size_t cached_head = 0;                           // producer's copy of head
+
+    alignas(CACHE_LINE) std::atomic<size_t> head{0};  // written by the consumer
+    size_t cached_tail = 0;                           // consumer's copy of tail
+
+    // Read by the other side on every operation, so not next to an index.
+    alignas(CACHE_LINE) Wait not_full;
+    alignas(CACHE_LINE) Wait not_empty;
+
+    // Free slots as seen by the producer; re-reads head only if the cached
+    // value leaves fewer than wanted.
+    size_t freeSlots(size_t t, size_t wanted);
+    // Filled slots as seen by the consumer.
+    size_t filledSlots(size_t h, size_t wanted);
+
+    // Wait conditions, read both shared indices.
+    bool hasRoom() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) < capacity();
+    }
+    bool hasData() const {
+        return tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed);
+    }
+};
+
+template <typename T, typename Wait>
+SpscQueue<T, Wait>::SpscQueue(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Capacity must be positive");
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    slots.reset(new T[rounded]);
+    mask = rounded - 1;
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::freeSlots(size_t t, size_t wanted) {
+    size_t free = capacity() - (t - cached_head);
+    if (free < wanted) {
+        cached_head = head.load(std::memory_order_acquire);
+        free = capacity() - (t - cached_head);
+    }
+    return free;
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::filledSlots(size_t h, size_t wanted) {
+    size_t filled = cached_tail - h;
+    if (filled < wanted) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        filled = cached_tail - h;
+    }
+    return filled;
+}
+
+template <typename T, typename Wait>
+template <typename U>
+bool SpscQueue<T, Wait>::tryPush(U&& element) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (freeSlots(t, 1) == 0) {
+        return false;
+    }
+    slots[t & mask] = std::forward<U>(element);
+    tail.store(t + 1, std::memory_order_release);
+    not_empty.notify();
+    return true;
+}
+
+template <typename T, typename Wait>
+template <typename U>
+void SpscQueue<T, Wait>::push(U&& element) {
+    while (!tryPush(std::forward<U>(element))) {
+        not_full.wait([this] { return hasRoom(); });
+    }
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::tryPushBatch(const T* elements, size_t n) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    n = std::min(n, freeSlots(t, n));
+    if (n == 0) {
+        return 0;
+    }
+    size_t start = t & mask;
+    size_t first_part = std::min(n, capacity() - start);
+    std::copy(elements, elements + first_part, slots.get() + start);
+    std::copy(elements + first_part, elements + n, slots.get());
+    tail.store(t + n, std::memory_order_release);
+    not_empty.notify();
+    return n;
+}
+
+template <typename T, typename Wait>
+void SpscQueue<T, Wait>::pushBatch(const T* elements, size_t n) {
+    while (n > 0) {
+        size_t pushed = tryPushBatch(elements, n);
+        elements += pushed;
+        n -= pushed;
+        if (pushed == 0) {
+            not_full.wait([this] { return hasRoom(); });
+        }
+    }
+}
+
+template <typename T, typename Wait>
+bool SpscQueue<T, Wait>::tryPop(T& out) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (filledSlots(h, 1) == 0) {
+        return false;
+    }
+    out = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    not_full.notify();
+    return true;
+}
+
+template <typename T, typename Wait>
+T SpscQueue<T, Wait>::pop() {
+    T out;
+    while (!tryPop(out)) {
+        not_empty.wait([this] { return hasData(); });
+    }
+    return out;
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::tryPopBatch(T* out, size_t max) {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t n = std::min(max, filledSlots(h, max));
+    if (n == 0) {
+        return 0;
+    }
+    size_t start = h & mask;
+    size_t first_part = std::min(n, capacity() - start);
+    std::move(slots.get() + start, slots.get() + start + first_part, out);
+    std::move(slots.get(), slots.get() + (n - first_part), out + first_part);
+    head.store(h + n, std::memory_order_release);
+    not_full.notify();
+    return n;
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::popBatch(T* out, size_t max) {
+    if (max == 0) {
+        return 0;
+    }
+    size_t n;
+    while ((n = tryPopBatch(out, max)) == 0) {
+        not_empty.wait([this] { return hasData(); });
+    }
+    return n;
+}
+
+template <typename T, typename Wait>
+size_t SpscQueue<T, Wait>::size() const {
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    return t > h ? t - h : 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// How a thread waits when a bounded queue is full (producer) or empty
+// (consumer). A policy has
+//     wait(ready) - returns once ready() is true
+//     notify()    - called after every change that may make ready() true
+// The queues keep one instance for "not empty" and one for "not full".
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Short busy wait. After a few pause instructions the thread yields, so a
+// waiter does not burn the time slice of the thread it waits for (matters
+// when there are more threads than cores).
+template <typename Ready>
+void spinUntil(Ready ready) {
+    for (unsigned spins = 0; !ready(); ++spins) {
+        if (spins < 64) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Never sleeps: lowest latency while a core is free, notify() costs nothing.
+struct SpinWait {
+    template <typename Ready>
+    void wait(Ready ready) { spinUntil(ready); }
+
+    void notify() {}
+};
+
+// Spins briefly, then sleeps on a condition variable. notify() only takes
+// the mutex when somebody sleeps, so an uncontended queue pays one fence
+// and one load per operation.
+class BlockingWait {
+public:
+    template <typename Ready>
+    void wait(Ready ready) {
+        for (unsigned spins = 0; spins < 128; ++spins) {
+            if (ready()) {
+                return;
+            }
+            cpuRelax();
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        sleepers.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in notify(): either the waiter sees the new
+        // state in ready(), or the notifier sees sleepers > 0.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeup.wait(guard, ready);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            // Taking the mutex orders the wakeup after the sleeper's check.
+            { std::lock_guard<std::mutex> guard(lock); }
+            wakeup.notify_all();
+        }
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable wakeup;
+    std::atomic<unsigned> sleepers{0};
+};
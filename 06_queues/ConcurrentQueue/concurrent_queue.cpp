@@ -0,0 +1,233 @@
+// g++ -O2 -std=c++17 -pthread concurrent_queue.cpp -o concurrent_queue
+//
+//   ./concurrent_queue [messages] [batch size]
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MpmcQueue.hpp"
+#include "SpscQueue.hpp"
+using namespace std;
+
+struct Message
+{
+    uint64_t value = 0;
+    int64_t sent_ns = 0; // steady_clock at push, for latency
+};
+
+const uint64_t STOP = UINT64_MAX;
+
+int64_t nowNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// What the pipeline used so far: std::deque under a mutex, with the same
+// member names as the lock-free queues.
+class MutexQueue
+{
+public:
+    explicit MutexQueue(size_t capacity) : limit(capacity) {}
+
+    void push(const Message& message) { pushBatch(&message, 1); }
+
+    void pushBatch(const Message* messages, size_t n)
+    {
+        while (n > 0)
+        {
+            unique_lock<mutex> guard(lock);
+            not_full.wait(guard, [this] { return queue.size() < limit; });
+            size_t k = min(n, limit - queue.size());
+            queue.insert(queue.end(), messages, messages + k);
+            messages += k;
+            n -= k;
+            guard.unlock();
+            not_empty.notify_all();
+        }
+    }
+
+    Message pop()
+    {
+        Message message;
+        popBatch(&message, 1);
+        return message;
+    }
+
+    size_t popBatch(Message* out, size_t max)
+    {
+        unique_lock<mutex> guard(lock);
+        not_empty.wait(guard, [this] { return !queue.empty(); });
+        size_t k = min(max, queue.size());
+        copy(queue.begin(), queue.begin() + k, out);
+        queue.erase(queue.begin(), queue.begin() + k);
+        guard.unlock();
+        not_full.notify_all();
+        return k;
+    }
+
+private:
+    mutex lock;
+    condition_variable not_empty, not_full;
+    deque<Message> queue;
+    size_t limit;
+};
+
+struct Result
+{
+    double seconds = 0;
+    uint64_t sum = 0;
+    bool ordered = true;      // per producer FIFO (values of one producer increase)
+    vector<int64_t> latency;  // every 64th message
+};
+
+// producers send values p, p + producers, p + 2 * producers, ... so every
+// value 0 .. messages-1 is sent exactly once; consumers stop on STOP.
+template <typename Queue>
+Result run(Queue& queue, unsigned producers, unsigned consumers, uint64_t messages, size_t batch)
+{
+    Result result;
+    vector<uint64_t> sums(consumers, 0);
+    vector<vector<int64_t>> latencies(consumers);
+    vector<char> ordered(consumers, 1);
+    vector<thread> threads;
+
+    auto start = chrono::steady_clock::now();
+    for (unsigned c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c] {
+            vector<Message> block(batch);
+            vector<uint64_t> last(producers, 0);
+            vector<char> seen(producers, 0);
+            uint64_t sum = 0, received = 0;
+            for (;;)
+            {
+                size_t n = batch == 1 ? (block[0] = queue.pop(), 1) : queue.popBatch(block.data(), batch);
+                int64_t now = nowNs();
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const Message& message = block[i];
+                    if (message.value == STOP)
+                    {
+                        // Only STOPs follow; a batch may have taken other
+                        // consumers' ones, give them back.
+                        for (size_t extra = i + 1; extra < n; ++extra)
+                            queue.push(Message{STOP, 0});
+                        sums[c] = sum;
+                        return;
+                    }
+                    unsigned from = message.value % producers;
+                    if (seen[from] && message.value <= last[from])
+                        ordered[c] = 0;
+                    seen[from] = 1;
+                    last[from] = message.value;
+                    sum += message.value;
+                    if (received++ % 64 == 0)
+                        latencies[c].push_back(now - message.sent_ns);
+                }
+            }
+        });
+    }
+
+    vector<thread> senders;
+    for (unsigned p = 0; p < producers; ++p)
+    {
+        senders.emplace_back([&, p] {
+            vector<Message> block;
+            for (uint64_t value = p; value < messages; value += producers)
+            {
+                block.push_back({value, nowNs()});
+                if (block.size() == batch)
+                {
+                    if (batch == 1)
+                        queue.push(block[0]);
+                    else
+                        queue.pushBatch(block.data(), block.size());
+                    block.clear();
+                }
+            }
+            if (!block.empty())
+                queue.pushBatch(block.data(), block.size());
+        });
+    }
+    for (thread& sender : senders)
+        sender.join();
+    for (unsigned c = 0; c < consumers; ++c)
+        queue.push(Message{STOP, 0});
+    for (thread& consumer : threads)
+        consumer.join();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (unsigned c = 0; c < consumers; ++c)
+    {
+        result.sum += sums[c];
+        result.ordered = result.ordered && ordered[c];
+        result.latency.insert(result.latency.end(), latencies[c].begin(), latencies[c].end());
+    }
+    sort(result.latency.begin(), result.latency.end());
+    return result;
+}
+
+double percentileUs(const vector<int64_t>& sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))] / 1000.0;
+}
+
+template <typename Queue>
+void report(const string& name, unsigned producers, unsigned consumers, uint64_t messages, size_t batch)
+{
+    Queue queue(4096);
+    Result result = run(queue, producers, consumers, messages, batch);
+    bool correct = result.sum == messages * (messages - 1) / 2 && result.ordered;
+    cout << "  " << name << producers << "p/" << consumers << "c  " << messages / result.seconds / 1e6
+         << " M msg/s, latency p50 " << percentileUs(result.latency, 0.5) << " us, p99 "
+         << percentileUs(result.latency, 0.99) << " us, p99.9 " << percentileUs(result.latency, 0.999) << " us"
+         << (correct ? "" : " WRONG") << "\n";
+}
+
+// popBatch with room for no elements returns at once, on an empty queue
+// too, instead of waiting for one it cannot take.
+template <typename Queue>
+bool emptyBatchReturns()
+{
+    Queue queue(16);
+    Message message{};
+    if (queue.popBatch(&message, 0) != 0)
+        return false;
+    queue.push(message);
+    return queue.popBatch(&message, 0) == 0 && queue.popBatch(&message, 1) == 1;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t messages = argc > 1 ? stoull(argv[1]) : 10000000;
+    size_t batch_size = argc > 2 ? stoul(argv[2]) : 64;
+    cout << thread::hardware_concurrency() << " hardware threads, " << messages << " messages\n";
+    bool empty_batch = emptyBatchReturns<SpscQueue<Message, SpinWait>>() &&
+                       emptyBatchReturns<SpscQueue<Message, BlockingWait>>() &&
+                       emptyBatchReturns<MpmcQueue<Message, SpinWait>>() &&
+                       emptyBatchReturns<MpmcQueue<Message, BlockingWait>>();
+    cout << "popBatch of 0 elements" << (empty_batch ? "" : " WRONG") << "\n";
+
+    for (size_t batch : {size_t(1), batch_size})
+    {
+        cout << (batch == 1 ? "single push/pop:\n" : "batches of " + to_string(batch) + ":\n");
+        report<SpscQueue<Message, SpinWait>>("SpscQueue spin       ", 1, 1, messages, batch);
+        report<SpscQueue<Message, BlockingWait>>("SpscQueue blocking   ", 1, 1, messages, batch);
+        for (unsigned threads : {1u, 2u, 4u})
+        {
+            report<MpmcQueue<Message, SpinWait>>("MpmcQueue spin       ", threads, threads, messages, batch);
+            report<MpmcQueue<Message, BlockingWait>>("MpmcQueue blocking   ", threads, threads, messages, batch);
+            report<MutexQueue>("mutex + std::deque   ", threads, threads, messages, batch);
+        }
+    }
+    return 0;
+}
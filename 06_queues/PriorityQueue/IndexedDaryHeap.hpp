@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Min-priority queue over the items 0 .. capacity - 1 (e.g. graph vertices),
+// each with a key. Every item is in the heap at most once and its position
+// is tracked, so decreaseKey moves it in place instead of pushing a
+// duplicate (the "lazy deletion" std::priority_queue needs).
+//
+// D children per node: a shallower tree than the binary heap, so sift-up
+// (push, decreaseKey) does fewer steps, and the D children compared in
+// sift-down are adjacent in memory.
+template <class Key, size_t D = 4, class Compare = std::less<Key>>
+class IndexedDaryHeap {
+public:
+    static_assert(D >= 2, "A heap node needs at least two children");
+
+    explicit IndexedDaryHeap(uint32_t capacity = 0, const Compare& compare = Compare());
+
+    // Resizes the item range and empties the heap.
+    void reset(uint32_t capacity);
+
+    bool isEmpty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(uint32_t item) const { return position[item] != NOT_IN_HEAP; }
+    const Key& key(uint32_t item) const;
+
+    void push(uint32_t item, const Key& key);
+    // key must not be larger than the current key of item.
+    void decreaseKey(uint32_t item, const Key& key);
+    // Push if absent, decreaseKey if key is smaller; false if nothing changed.
+    bool pushOrDecrease(uint32_t item, const Key& key);
+
+    uint32_t top() const;
+    const Key& topKey() const;
+    uint32_t pop();
+    void clear();
+
+private:
+    using Entry = std::pair<Key, uint32_t>;
+    static constexpr uint32_t NOT_IN_HEAP = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Entry> heap;
+    std::vector<uint32_t> position; // index in heap per item
+    Compare compare;
+
+    void place(size_t index, Entry&& entry)
+    {
+        position[entry.second] = static_cast<uint32_t>(index);
+        heap[index] = std::move(entry);
+    }
+
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+};
+
+template <class Key, size_t D, class Compare>
+IndexedDaryHeap<Key, D, Compare>::IndexedDaryHeap(uint32_t capacity, const Compare& compare)
+    : position(capacity, NOT_IN_HEAP), compare(compare) {}
+
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::reset(uint32_t capacity) {
+    heap.clear();
+    position.assign(capacity, NOT_IN_HEAP);
+}
+
+template <class Key, size_t D, class Compare>
+const Key& IndexedDaryHeap<Key, D, Compare>::key(uint32_t item) const {
+    if (!contains(item)) {
+        throw std::logic_error("Item is not in the heap");
+    }
+    return heap[position[item]].first;
+}
+
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::push(uint32_t item, const Key& key) {
+    if (contains(item)) {
+        throw std::logic_error("Item is already in the heap");
+    }
+    heap.emplace_back(key, item);
+    position[item] = static_cast<uint32_t>(heap.size() - 1);
+    siftUp(heap.size() - 1);
+}
+
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::decreaseKey(uint32_t item, const Key& key) {
+    if (!contains(item)) {
+        throw std::logic_error("Item is not in the heap");
+    }
+    size_t index = position[item];
+    if (compare(heap[index].first, key)) {
+        throw std::logic_error("decreaseKey with a larger key");
+    }
+    heap[index].first = key;
+    siftUp(index);
+}
+
+template <class Key, size_t D, class Compare>
+bool IndexedDaryHeap<Key, D, Compare>::pushOrDecrease(uint32_t item, const Key& key) {
+    if (!contains(item)) {
+        push(item, key);
+        return true;
+    }
+    size_t index = position[item];
+    if (!compare(key, heap[index].first)) {
+        return false;
+    }
+    heap[index].first = key;
+    siftUp(index);
+    return true;
+}
+
+template <class Key, size_t D, class Compare>
+uint32_t IndexedDaryHeap<Key, D, Compare>::top() const {
+    if (isEmpty()) {
+        throw std::logic_error("Heap is empty");
+    }
+    return heap.front().second;
+}
+
+template <class Key, size_t D, class Compare>
+const Key& IndexedDaryHeap<Key, D, Compare>::topKey() const {
+    if (isEmpty()) {
+        throw std::logic_error("Heap is empty");
+    }
+    return heap.front().first;
+}
+
+template <class Key, size_t D, class Compare>
+uint32_t IndexedDaryHeap<Key, D, Compare>::pop() {
+    uint32_t item = top();
+    position[item] = NOT_IN_HEAP;
+    Entry last = std::move(heap.back());
+    heap.pop_back();
+    if (!heap.empty()) {
+        place(0, std::move(last));
+        siftDown(0);
+    }
+    return item;
+}
+
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::clear() {
+    for (const Entry& entry : heap) {
+        position[entry.second] = NOT_IN_HEAP;
+    }
+    heap.clear();
+}
+
+// Both sifts move a hole instead of swapping: one write per level.
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::siftUp(size_t index) {
+    Entry moving = std::move(heap[index]);
+    while (index > 0) {
+        size_t parent = (index - 1) / D;
+        if (!compare(moving.first, heap[parent].first)) {
+            break;
+        }
+        place(index, std::move(heap[parent]));
+        index = parent;
+    }
+    place(index, std::move(moving));
+}
+
+template <class Key, size_t D, class Compare>
+void IndexedDaryHeap<Key, D, Compare>::siftDown(size_t index) {
+    Entry moving = std::move(heap[index]);
+    const size_t count = heap.size();
+    while (true) {
+        size_t first = index * D + 1;
+        if (first >= count) {
+            break;
+        }
+        size_t last = first + D < count ? first + D : count;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; ++child) {
+            if (compare(heap[child].first, heap[best].first)) {
+                best = child;
+            }
+        }
+        if (!compare(heap[best].first, moving.first)) {
+            break;
+        }
+        place(index, std::move(heap[best]));
+        index = best;
+    }
+    place(index, std::move(moving));
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Pairing heap over the items 0 .. capacity - 1 with decrease-key.
+//
+// A heap-ordered multiway tree stored as arrays indexed by item (first
+// child, next sibling, and previous sibling or parent for the leftmost
+// child), so there are no per-node allocations. push and decreaseKey just
+// link a tree under the root or the root under it, O(1); pop merges the
+// root's children pairwise left to right and then folds the pairs right to
+// left (two-pass pairing), amortised O(log n).
+template <class Key, class Compare = std::less<Key>>
+class PairingHeap {
+public:
+    explicit PairingHeap(uint32_t capacity = 0, const Compare& compare = Compare());
+
+    // Resizes the item range and empties the heap.
+    void reset(uint32_t capacity);
+
+    bool isEmpty() const { return root == NONE; }
+    size_t size() const { return count; }
+    bool contains(uint32_t item) const { return in_heap[item]; }
+    const Key& key(uint32_t item) const;
+
+    void push(uint32_t item, const Key& key);
+    // key must not be larger than the current key of item.
+    void decreaseKey(uint32_t item, const Key& key);
+    // Push if absent, decreaseKey if key is smaller; false if nothing changed.
+    bool pushOrDecrease(uint32_t item, const Key& key);
+
+    uint32_t top() const;
+    const Key& topKey() const { return keys[top()]; }
+    uint32_t pop();
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Key> keys;
+    std::vector<uint32_t> child;
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> prev;
+    std::vector<bool> in_heap;
+    std::vector<uint32_t> pairs; // scratch for pop
+    uint32_t root = NONE;
+    size_t count = 0;
+    Compare compare;
+
+    // Makes the tree with the larger root the first child of the other one.
+    uint32_t link(uint32_t a, uint32_t b);
+    void detach(uint32_t item);
+};
+
+template <class Key, class Compare>
+PairingHeap<Key, Compare>::PairingHeap(uint32_t capacity, const Compare& compare) : compare(compare) {
+    reset(capacity);
+}
+
+template <class Key, class Compare>
+void PairingHeap<Key, Compare>::reset(uint32_t capacity) {
+    keys.resize(capacity);
+    child.assign(capacity, NONE);
+    next.assign(capacity, NONE);
+    prev.assign(capacity, NONE);
+    in_heap.assign(capacity, false);
+    root = NONE;
+    count = 0;
+}
+
+template <class Key, class Compare>
+const Key& PairingHeap<Key, Compare>::key(uint32_t item) const {
+    if (!contains(item)) {
+        throw std::logic_error("Item is not in the heap");
+    }
+    return keys[item];
+}
+
+template <class Key, class Compare>
+uint32_t PairingHeap<Key, Compare>::link(uint32_t a, uint32_t b) {
+    if (compare(keys[b], keys[a])) {
+        std::swap(a, b);
+    }
+    // b becomes the leftmost child of a.
+    next[b] = child[a];
+    if (child[a] != NONE) {
+        prev[child[a]] = b;
+    }
+    prev[b] = a;
+    child[a] = b;
+    return a;
+}
+
+template <class Key, class Compare>
+void PairingHeap<Key, Compare>::detach(uint32_t item) {
+    if (child[prev[item]] == item) {
+        child[prev[item]] = next[item];
+    } else {
+        next[prev[item]] = next[item];
+    }
+    if (next[item] != NONE) {
+        prev[next[item]] = prev[item];
+    }
+    prev[item] = NONE;
+    next[item] = NONE;
+}
+
+template <class Key, class Compare>
+void PairingHeap<Key, Compare>::push(uint32_t item, const Key& key) {
+    if (contains(item)) {
+        throw std::logic_error("Item is already in the heap");
+    }
+    keys[item] = key;
+    child[item] = next[item] = prev[item] = NONE;
+    in_heap[item] = true;
+    root = root == NONE ? item : link(root, item);
+    count++;
+}
+
+template <class Key, class Compare>
+void PairingHeap<Key, Compare>::decreaseKey(uint32_t item, const Key& key) {
+    if (!contains(item)) {
+        throw std::logic_error("Item is not in the heap");
+    }
+    if (compare(keys[item], key)) {
+        throw std::logic_error("decreaseKey with a larger key");
+    }
+    keys[item] = key;
+    if (item != root) {
+        detach(item);
+        root = link(root, item);
+    }
+}
+
+template <class Key, class Compare>
+bool PairingHeap<Key, Compare>::pushOrDecrease(uint32_t item, const Key& key) {
+    if (!contains(item)) {
+        push(item, key);
+        return true;
+    }
+    if (!compare(key, keys[item])) {
+        return false;
+    }
+    decreaseKey(item, key);
+    return true;
+}
+
+template <class Key, class Compare>
+uint32_t PairingHeap<Key, Compare>::top() const {
+    if (isEmpty()) {
+        throw std::logic_error("Heap is empty");
+    }
+    return root;
+}
+
+template <class Key, class Compare>
+uint32_t PairingHeap<Key, Compare>::pop() {
+    uint32_t item = top();
+    in_heap[item] = false;
+    count--;
+
+    // First pass: link the children in pairs, left to right.
+    pairs.clear();
+    uint32_t current = child[item];
+    while (current != NONE) {
+        uint32_t second = next[current];
+        uint32_t after = second == NONE ? NONE : next[second];
+        prev[current] = next[current] = NONE;
+        if (second != NONE) {
+            prev[second] = next[second] = NONE;
+            current = link(current, second);
+        }
+        pairs.push_back(current);
+        current = after;
+    }
+    child[item] = NONE;
+
+    // Second pass: fold the pairs into one tree, right to left.
+    root = NONE;
+    for (size_t i = pairs.size(); i-- > 0;) {
+        root = root == NONE ? pairs[i] : link(pairs[i], root);
+    }
+    return item;
+}
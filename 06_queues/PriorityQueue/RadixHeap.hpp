@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Monotone min-priority queue for unsigned integer keys: a pushed key may
+// not be smaller than the last popped one. This holds for Dijkstra with
+// non-negative weights and for any event simulation that never goes back in
+// time.
+//
+// Bucket 0 holds keys equal to the last popped key, bucket b > 0 the keys
+// whose highest bit differing from it is bit b - 1. Popping from an empty
+// bucket 0 takes the first non-empty bucket, makes its minimum the new
+// "last" and redistributes it; every element moves to a strictly lower
+// bucket each time, so it is moved at most 64 times in total. Duplicates
+// of the same value are allowed (lazy deletion for decrease-key).
+template <class Value = uint32_t>
+class RadixHeap {
+public:
+    using Entry = std::pair<uint64_t, Value>;
+
+    bool isEmpty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(uint64_t key, const Value& value);
+
+    // Smallest key; pulls the next bucket down if needed.
+    uint64_t topKey();
+    Entry pop();
+    void clear();
+
+private:
+    static constexpr size_t BUCKETS = 65;
+
+    std::vector<Entry> buckets[BUCKETS];
+    uint64_t last = 0;
+    size_t count = 0;
+
+    static size_t bucketOf(uint64_t key, uint64_t last) {
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+
+    void refill();
+};
+
+template <class Value>
+void RadixHeap<Value>::push(uint64_t key, const Value& value) {
+    if (key < last) {
+        throw std::logic_error("RadixHeap keys must not go below the last popped key");
+    }
+    buckets[bucketOf(key, last)].emplace_back(key, value);
+    count++;
+}
+
+template <class Value>
+void RadixHeap<Value>::refill() {
+    if (!buckets[0].empty()) {
+        return;
+    }
+    if (count == 0) {
+        throw std::logic_error("Heap is empty");
+    }
+
+    size_t b = 1;
+    while (buckets[b].empty()) {
+        b++;
+    }
+    uint64_t smallest = std::numeric_limits<uint64_t>::max();
+    for (const Entry& entry : buckets[b]) {
+        smallest = entry.first < smallest ? entry.first : smallest;
+    }
+    last = smallest;
+    for (Entry& entry : buckets[b]) {
+        buckets[bucketOf(entry.first, last)].push_back(std::move(entry));
+    }
+    buckets[b].clear();
+}
+
+template <class Value>
+uint64_t RadixHeap<Value>::topKey() {
+    refill();
+    return last;
+}
+
+template <class Value>
+typename RadixHeap<Value>::Entry RadixHeap<Value>::pop() {
+    refill();
+    Entry entry = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    count--;
+    return entry;
+}
+
+template <class Value>
+void RadixHeap<Value>::clear() {
+    for (std::vector<Entry>& bucket : buckets) {
+        bucket.clear();
+    }
+    last = 0;
+    count = 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+// The queue abstraction from Queues.md.
+template <typename T>
+class QueueInterface {
+public:
+    virtual ~QueueInterface() = default;
+
+    // Inserts element at the end of the queue
+    virtual void push(const T& element) = 0;
+    // Returns the element at the back of the queue - the most recently pushed element
+    virtual T back() = 0;
+
+    // Returns the element at the front of the queue
+    virtual T front() = 0;
+
+    // Removes the first element
+    virtual void pop() = 0;
+
+    virtual bool isEmpty() const = 0;
+    virtual size_t size() const = 0;
+};
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "../QueueInterface.hpp"
+
+// FIFO queue in a circular array. The capacity is a power of two, so the
+// slot of the i-th element is (head + i) & mask - no division and no
+// branch on wrap-around. When the ring is full it grows 2x; the elements
+// are moved once into the new buffer in queue order (the two wrapped
+// segments one after the other), so the new ring starts unwrapped.
+//
+// A moved-from queue is empty with no buffer; it takes one on the next
+// push or reserve.
+//
+// The class is final: calls on a RingQueue (not through a QueueInterface
+// reference) are resolved statically and inlined.
+template <typename T>
+class RingQueue final : public QueueInterface<T> {
+public:
+    explicit RingQueue(size_t initial_capacity = 16);
+    RingQueue(const RingQueue& other);
+    RingQueue(RingQueue&& other) noexcept;
+    RingQueue& operator=(RingQueue other) noexcept;
+    ~RingQueue() override;
+
+    void push(const T& element) override { emplace(element); }
+    void push(T&& element) { emplace(std::move(element)); }
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    T back() override { return peekBack(); }
+    T front() override { return peekFront(); }
+
+    void pop() override {
+        if (isEmpty()) {
+            throwEmpty();
+        }
+        data[head].~T();
+        head = (head + 1) & mask;
+        count--;
+    }
+
+    bool isEmpty() const override { return count == 0; }
+    size_t size() const override { return count; }
+    // 0 only for a moved-from queue, which has no buffer (mask wraps).
+    size_t capacity() const { return mask + 1; }
+
+    // Access without the copy the interface makes.
+    T& peekFront() {
+        if (isEmpty()) {
+            throwEmpty();
+        }
+        return data[head];
+    }
+
+    T& peekBack() {
+        if (isEmpty()) {
+            throwEmpty();
+        }
+        return data[(head + count - 1) & mask];
+    }
+
+    // Bulk operations: at most two contiguous copies each.
+    void pushRange(const T* first, size_t n);
+    // Moves up to max elements from the front into out, returns how many.
+    size_t popRange(T* out, size_t max);
+
+    void reserve(size_t n);
+    void clear();
+
+private:
+    T* data = nullptr;
+    size_t mask = 0;
+    size_t head = 0;
+    size_t count = 0;
+
+    static size_t roundUp(size_t n);
+    static T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    // Out of line and cold, so the hot members above stay small enough to
+    // be inlined.
+    [[noreturn]] static void throwEmpty();
+    template <typename... Args>
+    [[gnu::noinline]] void growAndEmplace(Args&&... args);
+    // Moves the elements to the front of `moved` (new_capacity slots) and
+    // frees the old buffer.
+    void relocate(T* moved, size_t new_capacity);
+};
+
+template <typename T>
+size_t RingQueue<T>::roundUp(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+template <typename T>
+void RingQueue<T>::throwEmpty() {
+    throw std::logic_error("Queue is empty");
+}
+
+template <typename T>
+RingQueue<T>::RingQueue(size_t initial_capacity) {
+    size_t capacity = roundUp(std::max<size_t>(initial_capacity, 1));
+    data = allocate(capacity);
+    mask = capacity - 1;
+}
+
+template <typename T>
+RingQueue<T>::RingQueue(const RingQueue& other) : RingQueue(other.capacity()) {
+    for (size_t i = 0; i < other.count; ++i) {
+        new (data + i) T(other.data[(other.head + i) & other.mask]);
+        count++;
+    }
+}
+
+template <typename T>
+RingQueue<T>::RingQueue(RingQueue&& other) noexcept
+    : data(other.data), mask(other.mask), head(other.head), count(other.count) {
+    other.data = nullptr;
+    other.mask = SIZE_MAX;  // capacity() 0: the next push allocates
+    other.head = other.count = 0;
+}
+
+template <typename T>
+RingQueue<T>& RingQueue<T>::operator=(RingQueue other) noexcept {
+    std::swap(data, other.data);
+    std::swap(mask, other.mask);
+    std::swap(head, other.head);
+    std::swap(count, other.count);
+    return *this;
+}
+
+template <typename T>
+RingQueue<T>::~RingQueue() {
+    clear();
+    ::operator delete(data);
+}
+
+template <typename T>
+void RingQueue<T>::relocate(T* moved, size_t new_capacity) {
+    size_t first_part = std::min(count, capacity() - head);
+    std::uninitialized_move(data + head, data + head + first_part, moved);
+    std::uninitialized_move(data, data + (count - first_part), moved + first_part);
+    std::destroy(data + head, data + head + first_part);
+    std::destroy(data, data + (count - first_part));
+    ::operator delete(data);
+    data = moved;
+    mask = new_capacity - 1;
+    head = 0;
+}
+
+template <typename T>
+template <typename... Args>
+void RingQueue<T>::emplace(Args&&... args) {
+    if (count == capacity()) {
+        growAndEmplace(std::forward<Args>(args)...);
+        return;
+    }
+    new (data + ((head + count) & mask)) T(std::forward<Args>(args)...);
+    count++;
+}
+
+template <typename T>
+template <typename... Args>
+void RingQueue<T>::growAndEmplace(Args&&... args) {
+    // The new element first: args may refer to an element of this queue,
+    // which relocate() moves and frees.
+    size_t new_capacity = data ? capacity() * 2 : 1;
+    T* moved = allocate(new_capacity);
+    try {
+        new (moved + count) T(std::forward<Args>(args)...);
+    } catch (...) {
+        ::operator delete(moved);
+        throw;
+    }
+    relocate(moved, new_capacity);
+    count++;
+}
+
+template <typename T>
+void RingQueue<T>::pushRange(const T* first, size_t n) {
+    if (count + n > capacity()) {
+        // Same as growAndEmplace: the range may lie in this queue.
+        size_t new_capacity = roundUp(count + n);
+        T* moved = allocate(new_capacity);
+        try {
+            std::uninitialized_copy(first, first + n, moved + count);
+        } catch (...) {
+            ::operator delete(moved);
+            throw;
+        }
+        relocate(moved, new_capacity);
+        count += n;
+        return;
+    }
+    size_t tail = (head + count) & mask;
+    size_t first_part = std::min(n, capacity() - tail);
+    std::uninitialized_copy(first, first + first_part, data + tail);
+    std::uninitialized_copy(first + first_part, first + n, data);
+    count += n;
+}
+
+template <typename T>
+size_t RingQueue<T>::popRange(T* out, size_t max) {
+    size_t n = std::min(max, count);
+    size_t first_part = std::min(n, capacity() - head);
+    std::move(data + head, data + head + first_part, out);
+    std::move(data, data + (n - first_part), out + first_part);
+    std::destroy(data + head, data + head + first_part);
+    std::destroy(data, data + (n - first_part));
+    head = (head + n) & mask;
+    count -= n;
+    return n;
+}
+
+template <typename T>
+void RingQueue<T>::reserve(size_t n) {
+    if (n > capacity()) {
+        relocate(allocate(roundUp(n)), roundUp(n));
+    }
+}
+
+template <typename T>
+void RingQueue<T>::clear() {
+    while (count > 0) {
+        data[head].~T();
+        head = (head + 1) & mask;
+        count--;
+    }
+    head = 0;
+}
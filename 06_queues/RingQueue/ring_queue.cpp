@@ -0,0 +1,252 @@
+// g++ -O2 -std=c++17 ring_queue.cpp -o ring_queue
+//
+//   ./ring_queue [operations] [bfs vertices]
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../04/DoublyLinkedList/generic/DoublyLinkedList.hpp"
+#include "../../09/graphs/CsrGraph.hpp"
+#include "RingQueue.hpp"
+using namespace std;
+
+// The linked-list implementation from Queues.md.
+template <typename T>
+class LinkedQueue final : public QueueInterface<T> {
+public:
+    void push(const T& element) override { list.pushBack(element); }
+    T back() override { return list.back(); }
+    T front() override { return list.front(); }
+    void pop() override { list.popFront(); }
+    bool isEmpty() const override { return list.isEmpty(); }
+    size_t size() const override { return list.getSize(); }
+
+private:
+    DoublyLinkedList<T> list;
+};
+
+// std::queue with the same member names.
+template <typename T>
+class StdQueue {
+public:
+    void push(const T& element) { queue.push(element); }
+    T front() { return queue.front(); }
+    void pop() { queue.pop(); }
+    bool isEmpty() const { return queue.empty(); }
+
+private:
+    std::queue<T> queue;
+};
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Keeps about `depth` elements queued: push one, pop one.
+template <typename Queue>
+uint64_t steadyState(Queue& queue, uint64_t operations, uint32_t depth)
+{
+    uint64_t checksum = 0;
+    for (uint32_t i = 0; i < depth; ++i)
+        queue.push(i);
+    for (uint64_t i = 0; i < operations; ++i)
+    {
+        queue.push(static_cast<uint32_t>(i));
+        checksum += queue.front();
+        queue.pop();
+    }
+    while (!queue.isEmpty())
+        queue.pop();
+    return checksum;
+}
+
+// Fill to `operations` elements, then drain.
+template <typename Queue>
+uint64_t fillDrain(Queue& queue, uint64_t operations)
+{
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < operations; ++i)
+        queue.push(static_cast<uint32_t>(i));
+    while (!queue.isEmpty())
+    {
+        checksum += queue.front();
+        queue.pop();
+    }
+    return checksum;
+}
+
+// Every call only through the interface. Kept out of line so the compiler
+// cannot see the concrete type and has to dispatch virtually.
+[[gnu::noinline]] uint64_t steadyStateVirtual(QueueInterface<uint32_t>& queue, uint64_t operations,
+                                              uint32_t depth)
+{
+    return steadyState(queue, operations, depth);
+}
+
+template <typename Queue>
+void measure(const string& name, uint64_t operations, uint32_t depth)
+{
+    Queue queue;
+    auto start = chrono::steady_clock::now();
+    uint64_t checksum = depth ? steadyState(queue, operations, depth) : fillDrain(queue, operations);
+    double seconds = secondsSince(start);
+    cout << "  " << name << seconds / operations * 1e9 << " ns/op (checksum " << checksum << ")\n";
+}
+
+template <typename Queue>
+vector<uint32_t> bfs(const CsrGraph& graph, uint32_t source)
+{
+    Queue frontier;
+    vector<uint32_t> distance(graph.vertex_count, UINT32_MAX);
+    distance[source] = 0;
+    frontier.push(source);
+    while (!frontier.isEmpty())
+    {
+        uint32_t current = frontier.front();
+        frontier.pop();
+        for (const uint32_t* it = graph.neighborsBegin(current); it != graph.neighborsEnd(current); ++it)
+        {
+            if (distance[*it] == UINT32_MAX)
+            {
+                distance[*it] = distance[current] + 1;
+                frontier.push(*it);
+            }
+        }
+    }
+    return distance;
+}
+
+// Same BFS moving whole adjacency lists in and whole blocks out.
+vector<uint32_t> bfsBulk(const CsrGraph& graph, uint32_t source)
+{
+    vector<uint32_t> distance(graph.vertex_count, UINT32_MAX);
+    RingQueue<uint32_t> frontier;
+    vector<uint32_t> block(4096), fresh;
+    distance[source] = 0;
+    frontier.push(source);
+    while (!frontier.isEmpty())
+    {
+        size_t taken = frontier.popRange(block.data(), block.size());
+        for (size_t i = 0; i < taken; ++i)
+        {
+            fresh.clear();
+            for (const uint32_t* it = graph.neighborsBegin(block[i]); it != graph.neighborsEnd(block[i]); ++it)
+            {
+                if (distance[*it] == UINT32_MAX)
+                {
+                    distance[*it] = distance[block[i]] + 1;
+                    fresh.push_back(*it);
+                }
+            }
+            frontier.pushRange(fresh.data(), fresh.size());
+        }
+    }
+    return distance;
+}
+
+// Edge cases, checked against the expected contents.
+void checkEdgeCases()
+{
+    // A moved-from queue is empty and usable again: by push, by pushRange
+    // (through reserve) and as the source of a copy.
+    {
+        RingQueue<uint32_t> from;
+        from.push(1);
+        RingQueue<uint32_t> to(move(from));
+        RingQueue<uint32_t> empty_copy(from);
+        bool same = from.isEmpty() && empty_copy.isEmpty() && to.size() == 1 && to.front() == 1;
+        from.push(2);
+        from.push(3);
+        same = same && from.size() == 2 && from.front() == 2 && from.back() == 3;
+        to = move(from);
+        uint32_t more[] = {4, 5, 6};
+        from.pushRange(more, 3);
+        same = same && to.size() == 2 && from.size() == 3 && from.front() == 4 && from.back() == 6;
+        cout << "moved-from RingQueue reused" << (same ? "" : " MISMATCH") << "\n";
+    }
+
+    // Pushing the queue's own elements while it grows: the argument lives
+    // in the buffer that is being replaced.
+    {
+        RingQueue<string> names(2);
+        names.push("Александър Петров");
+        names.push("Мария Иванова");
+        names.push(names.peekFront());
+        names.pushRange(&names.peekFront(), 3);
+        bool same = names.size() == 6;
+        const char* expected[] = {"Александър Петров", "Мария Иванова", "Александър Петров"};
+        for (int round = 0; round < 2; ++round)
+        {
+            for (const char* name : expected)
+            {
+                same = same && names.peekFront() == name;
+                names.pop();
+            }
+        }
+        cout << "RingQueue self-push while growing" << (same ? "" : " MISMATCH") << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t operations = argc > 1 ? stoull(argv[1]) : 20000000;
+    uint32_t n = argc > 2 ? stoul(argv[2]) : 1000000;
+
+    for (uint32_t depth : {16u, 100000u})
+    {
+        cout << "steady state, " << depth << " queued:\n";
+        measure<RingQueue<uint32_t>>("RingQueue                    ", operations, depth);
+        {
+            RingQueue<uint32_t> ring;
+            auto start = chrono::steady_clock::now();
+            uint64_t checksum = steadyStateVirtual(ring, operations, depth);
+            cout << "  RingQueue via QueueInterface " << secondsSince(start) / operations * 1e9
+                 << " ns/op (checksum " << checksum << ")\n";
+        }
+        measure<StdQueue<uint32_t>>("std::queue                   ", operations, depth);
+        measure<LinkedQueue<uint32_t>>("DoublyLinkedList queue       ", operations, depth);
+    }
+
+    cout << "fill " << operations << " then drain:\n";
+    measure<RingQueue<uint32_t>>("RingQueue                    ", operations, 0);
+    {
+        // Same without the doublings: growth is the whole difference.
+        RingQueue<uint32_t> ring;
+        ring.reserve(operations);
+        auto start = chrono::steady_clock::now();
+        uint64_t checksum = fillDrain(ring, operations);
+        cout << "  RingQueue after reserve()    " << secondsSince(start) / operations * 1e9
+             << " ns/op (checksum " << checksum << ")\n";
+    }
+    measure<StdQueue<uint32_t>>("std::queue                   ", operations, 0);
+    measure<LinkedQueue<uint32_t>>("DoublyLinkedList queue       ", operations, 0);
+
+    checkEdgeCases();
+
+    // BFS frontier on a random graph with 10 edges per vertex.
+    mt19937_64 rng(59);
+    vector<pair<uint32_t, uint32_t>> edges(uint64_t(n) * 5);
+    for (auto& edge : edges)
+        edge = {static_cast<uint32_t>(rng() % n), static_cast<uint32_t>(rng() % n)};
+    CsrGraph graph = CsrGraph::fromEdges(n, edges);
+    cout << "BFS frontier, " << n << " vertices, " << graph.edgeCount() << " arcs:\n";
+
+    auto start = chrono::steady_clock::now();
+    vector<uint32_t> expected = bfs<StdQueue<uint32_t>>(graph, 0);
+    cout << "  std::queue              " << secondsSince(start) << " s\n";
+    start = chrono::steady_clock::now();
+    bool same = bfs<RingQueue<uint32_t>>(graph, 0) == expected;
+    cout << "  RingQueue               " << secondsSince(start) << " s" << (same ? "" : " MISMATCH") << "\n";
+    start = chrono::steady_clock::now();
+    same = bfsBulk(graph, 0) == expected;
+    cout << "  RingQueue pushRange     " << secondsSince(start) << " s" << (same ? "" : " MISMATCH") << "\n";
+    start = chrono::steady_clock::now();
+    same = bfs<LinkedQueue<uint32_t>>(graph, 0) == expected;
+    cout << "  DoublyLinkedList queue  " << secondsSince(start) << " s" << (same ? "" : " MISMATCH") << "\n";
+    return 0;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../LinearProbingHash/map/HashMap.hpp"
+
+// A string key that does not own its characters: pointer, length and the
+// hash, 16 bytes. The hash is computed once, when the StringRef is made,
+// so a table never hashes the characters again (not when it grows either),
+// and two StringRefs with different hashes are unequal without looking at
+// the characters. std::hash<StringRef> returns it, so HashMap, HashSet,
+// UnorderedMap and UnorderedSet take StringRef keys as they are.
+//
+// The characters must outlive the StringRef; StringPool keeps them.
+class StringRef {
+ public:
+  StringRef() = default;
+  explicit StringRef(std::string_view text);
+
+  std::string_view view() const { return std::string_view(data, length); }
+  size_t size() const { return length; }
+  uint32_t hash() const { return hash_value; }
+
+  bool operator==(const StringRef& other) const;
+  bool operator!=(const StringRef& other) const { return !(*this == other); }
+
+  static uint32_t hashOf(std::string_view text);
+
+ private:
+  const char* data = nullptr;
+  uint32_t length = 0;
+  uint32_t hash_value = hashOf(std::string_view());
+};
+
+namespace std {
+template <>
+struct hash<StringRef> {
+  size_t operator()(const StringRef& ref) const { return ref.hash(); }
+};
+}  // namespace std
+
+inline uint32_t StringRef::hashOf(std::string_view text) {
+  // 8 bytes per multiply, then a final mix (the table takes the low bits).
+  const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+  uint64_t h = text.size() * MULTIPLIER;
+  size_t i = 0;
+  for (; i + 8 <= text.size(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, text.data() + i, 8);
+    h = (h ^ word) * MULTIPLIER;
+    h ^= h >> 29;
+  }
+  // The tail, zero-padded. Not by a short memcpy into word: the 8-byte
+  // reload after a partial store waits for the store to retire, and with
+  // it for the cache misses of the lookup before.
+  size_t tail = text.size() - i;
+  if (tail > 0) {
+    uint64_t word = 0;
+    if (text.size() >= 8) {
+      std::memcpy(&word, text.data() + text.size() - 8, 8);
+      word >>= 8 * (8 - tail);
+    } else {
+      for (size_t j = 0; j < tail; ++j) {
+        word |= static_cast<uint64_t>(static_cast<unsigned char>(text[i + j]))
+                << (8 * j);
+      }
+    }
+    h = (h ^ word) * MULTIPLIER;
+  }
+  h ^= h >> 32;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 32;
+  return static_cast<uint32_t>(h);
+}
+
+inline StringRef::StringRef(std::string_view text)
+    : data(text.data()),
+      length(static_cast<uint32_t>(text.size())),
+      hash_value(hashOf(text)) {
+  if (text.size() > UINT32_MAX) {
+    throw std::length_error("String too long for a StringRef");
+  }
+}
+
+inline bool StringRef::operator==(const StringRef& other) const {
+  if (hash_value != other.hash_value || length != other.length) {
+    return false;
+  }
+  // Refs from one pool share the characters of equal strings.
+  return data == other.data || length == 0 ||
+         std::memcmp(data, other.data, length) == 0;
+}
+
+// Interning: every distinct string is stored once and named by a 32-bit
+// handle, 0, 1, 2, ... in order of first appearance.
+//
+// The characters go to an append-only arena of CHUNK-byte blocks (a string
+// over CHUNK / 4 bytes gets a block of its own), so they never move and the
+// StringRefs into them stay valid for the life of the pool. A HashMap from
+// 07_hash over those StringRefs finds the handle of a string.
+//
+// A record keeps a 4-byte handle instead of a std::string: no 32-byte
+// string object, no heap block per copy, one copy of the characters.
+class StringPool {
+ public:
+  using Handle = uint32_t;
+
+  explicit StringPool(size_t expected_strings = 16);
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  // The handle of text, added if it is new.
+  Handle intern(std::string_view text);
+  std::optional<Handle> find(std::string_view text) const;
+
+  // Valid as long as the pool.
+  StringRef get(Handle handle) const { return refs[handle]; }
+  std::string_view view(Handle handle) const { return refs[handle].view(); }
+
+  size_t getSize() const { return refs.size(); }
+
+ private:
+  static const size_t CHUNK = 1 << 20;
+
+  std::vector<std::unique_ptr<char[]>> chunks;
+  size_t chunk_used = 0;  // bytes of chunks.back()
+  std::vector<std::unique_ptr<char[]>> large;  // one string each
+  std::vector<StringRef> refs;
+  HashMap<StringRef, Handle> index;
+
+  static size_t tableSize(size_t expected_strings);
+  const char* store(std::string_view text);
+};
+
+inline size_t StringPool::tableSize(size_t expected_strings) {
+  // Below the 80% at which HashMap doubles, and not a multiple of its
+  // probe step 3, or a probe would only see every third bucket.
+  size_t size = expected_strings / 4 * 5 + 16;
+  return size % 3 == 0 ? size + 1 : size;
+}
+
+inline StringPool::StringPool(size_t expected_strings)
+    : index(tableSize(expected_strings)) {
+  refs.reserve(expected_strings);
+}
+
+inline const char* StringPool::store(std::string_view text) {
+  if (text.size() > CHUNK / 4) {
+    large.push_back(std::make_unique<char[]>(text.size()));
+    std::memcpy(large.back().get(), text.data(), text.size());
+    return large.back().get();
+  }
+  if (chunks.empty() || CHUNK - chunk_used < text.size()) {
+    chunks.push_back(std::make_unique<char[]>(CHUNK));
+    chunk_used = 0;
+  }
+  char* at = chunks.back().get() + chunk_used;
+  std::memcpy(at, text.data(), text.size());
+  chunk_used += text.size();
+  return at;
+}
+
+inline StringPool::Handle StringPool::intern(std::string_view text) {
+  StringRef probe(text);
+  auto found = index.get(probe);
+  if (found != index.cend()) {
+    return (*found).second;
+  }
+  if (refs.size() == UINT32_MAX) {
+    throw std::length_error("String pool is full");
+  }
+  StringRef stored(std::string_view(store(text), text.size()));
+  Handle handle = static_cast<Handle>(refs.size());
+  refs.push_back(stored);
+  index.add(stored, handle);
+  return handle;
+}
+
+inline std::optional<StringPool::Handle> StringPool::find(
+    std::string_view text) const {
+  auto found = index.get(StringRef(text));
+  if (found == index.cend()) {
+    return std::nullopt;
+  }
+  return (*found).second;
+}
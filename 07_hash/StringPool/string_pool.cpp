@@ -0,0 +1,142 @@
+// g++ -O2 -std=c++17 string_pool.cpp -o string_pool
+//
+//   ./string_pool [records] [distinct names]
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../LinearProbingHash/map/HashMap.hpp"
+#include "StringPool.hpp"
+using namespace std;
+
+// Live heap bytes, counted in the global operator new / delete.
+size_t liveBytes = 0;
+
+void* operator new(size_t size) {
+  void* p = malloc(size);
+  if (!p) {
+    throw bad_alloc();
+  }
+  liveBytes += malloc_usable_size(p);
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p) {
+    liveBytes -= malloc_usable_size(p);
+    free(p);
+  }
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+const char* FIRST[] = {"Александър", "Мария",    "Георги",  "Елена",     "Иван",     "Христина",
+                       "Николай",    "Петя",     "Стоян",   "Виктория",  "Димитър",  "Радослава",
+                       "Любомир",    "Теодора",  "Красимир", "Гергана",  "Калоян",   "Десислава",
+                       "Мартин",     "Цветелина"};
+const char* LAST[] = {"Петров",  "Иванов",  "Димитров", "Георгиев", "Николов", "Стоянов", "Василев",
+                      "Атанасов", "Тодоров", "Костов",   "Христов",  "Маринов", "Симеонов", "Колев",
+                      "Йорданов", "Ангелов", "Попов",    "Илиев",    "Михайлов", "Павлов"};
+
+// Distinct name d: first, father's and family name; past the 8000
+// combinations a number makes them distinct.
+string nameOf(uint64_t d) {
+  bool female = d % 2;
+  const char* suffix = female ? "а" : "";
+  string name = string(FIRST[d % 20]) + " " + LAST[d / 20 % 20] + suffix + " " + LAST[d / 400 % 20] + suffix;
+  if (d >= 8000) {
+    name += " " + to_string(d / 8000);
+  }
+  return name;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Map, typename Key>
+void lookups(const string& name, const Map& map, size_t count, Key key) {
+  auto start = chrono::steady_clock::now();
+  uint64_t sum = 0;
+  for (size_t i = 0; i < count; ++i) {
+    auto found = map.get(key(i));
+    sum += found != map.cend() ? (*found).second : 0;
+  }
+  double seconds = secondsSince(start);
+  cout << "    " << name << count / seconds / 1e6 << " M lookups/s  (checksum " << sum << ")\n";
+}
+
+int main(int argc, char** argv) {
+  size_t records = argc > 1 ? stoull(argv[1]) : 50000000;
+  size_t distinct = argc > 2 ? stoull(argv[2]) : 8000;
+
+  // Which distinct name every record has.
+  mt19937_64 rng(50);
+  vector<uint32_t> picks(records);
+  for (uint32_t& pick : picks) {
+    pick = static_cast<uint32_t>(rng() % distinct);
+  }
+  // Lookups from outside text: names as they would arrive in a query.
+  const size_t QUERIES = 1000000;
+  vector<string> queries(QUERIES);
+  for (string& query : queries) {
+    query = nameOf(rng() % distinct);
+  }
+  size_t baseline = liveBytes;
+  cout << records << " records, " << distinct << " distinct names\n";
+
+  {
+    cout << "  std::string per record, HashMap<std::string, uint32_t>:\n";
+    auto start = chrono::steady_clock::now();
+    vector<string> names(records);
+    for (size_t r = 0; r < records; ++r) {
+      names[r] = nameOf(picks[r]);
+    }
+    HashMap<string, uint32_t> ids;
+    for (size_t d = 0; d < distinct; ++d) {
+      ids.add(nameOf(d), static_cast<uint32_t>(d));
+    }
+    cout << "    built in " << secondsSince(start) << " s, " << double(liveBytes - baseline) / records
+         << " bytes/record\n";
+    lookups("by record key  ", ids, records, [&](size_t i) -> const string& { return names[i]; });
+    lookups("by query text  ", ids, QUERIES, [&](size_t i) -> const string& { return queries[i]; });
+  }
+
+  {
+    cout << "  StringPool handle per record, HashMap<StringRef, uint32_t>:\n";
+    auto start = chrono::steady_clock::now();
+    StringPool pool(distinct);
+    for (size_t d = 0; d < distinct; ++d) {
+      pool.intern(nameOf(d));
+    }
+    vector<StringPool::Handle> handles(records);
+    for (size_t r = 0; r < records; ++r) {
+      handles[r] = pool.intern(nameOf(picks[r]));
+    }
+    // The same map as above, keyed by the pool's refs (handle d is name d).
+    HashMap<StringRef, uint32_t> ids;
+    for (size_t d = 0; d < distinct; ++d) {
+      ids.add(pool.get(static_cast<StringPool::Handle>(d)), static_cast<uint32_t>(d));
+    }
+    cout << "    built in " << secondsSince(start) << " s, " << double(liveBytes - baseline) / records
+         << " bytes/record\n";
+    lookups("by record key  ", ids, records, [&](size_t i) { return pool.get(handles[i]); });
+    lookups("by query text  ", ids, QUERIES, [&](size_t i) { return StringRef(queries[i]); });
+
+    start = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (size_t i = 0; i < QUERIES; ++i) {
+      sum += pool.find(queries[i]).value_or(0);
+    }
+    cout << "    StringPool::find, query text " << QUERIES / secondsSince(start) / 1e6 << " M lookups/s  (checksum "
+         << sum << ")\n";
+  }
+  return 0;
+}
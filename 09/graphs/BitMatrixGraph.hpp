@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Row-wise bit operations used by BitMatrixGraph. Row pointers are 64-byte
+// aligned and the word count is a multiple of 8, so the AVX2 loops need no
+// scalar tail.
+namespace bitrow
+{
+#ifdef __AVX2__
+    // Mula's nibble-lookup popcount: count bits per nibble with a shuffle,
+    // then sum bytes with sad_epu8 into four 64-bit lanes.
+    inline __m256i popcount256(__m256i v)
+    {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0f);
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                         _mm256_shuffle_epi8(lookup, hi));
+        return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+    }
+
+    inline uint64_t sum256(__m256i v)
+    {
+        return static_cast<uint64_t>(_mm256_extract_epi64(v, 0)) + _mm256_extract_epi64(v, 1) +
+               _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3);
+    }
+#endif
+
+    inline uint64_t popcount(const uint64_t* a, size_t words)
+    {
+#ifdef __AVX2__
+        __m256i total = _mm256_setzero_si256();
+        for (size_t i = 0; i < words; i += 4)
+            total = _mm256_add_epi64(total, popcount256(_mm256_load_si256(reinterpret_cast<const __m256i*>(a + i))));
+        return sum256(total);
+#else
+        uint64_t total = 0;
+        for (size_t i = 0; i < words; ++i)
+            total += __builtin_popcountll(a[i]);
+        return total;
+#endif
+    }
+
+    // popcount(a & b) without materialising the intersection.
+    inline uint64_t popcountAnd(const uint64_t* a, const uint64_t* b, size_t words)
+    {
+#ifdef __AVX2__
+        __m256i total = _mm256_setzero_si256();
+        for (size_t i = 0; i < words; i += 4)
+        {
+            __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_load_si256(reinterpret_cast<const __m256i*>(b + i));
+            total = _mm256_add_epi64(total, popcount256(_mm256_and_si256(x, y)));
+        }
+        return sum256(total);
+#else
+        uint64_t total = 0;
+        for (size_t i = 0; i < words; ++i)
+            total += __builtin_popcountll(a[i] & b[i]);
+        return total;
+#endif
+    }
+
+    inline void orInto(uint64_t* dst, const uint64_t* src, size_t words)
+    {
+#ifdef __AVX2__
+        for (size_t i = 0; i < words; i += 4)
+        {
+            __m256i* d = reinterpret_cast<__m256i*>(dst + i);
+            __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_store_si256(d, _mm256_or_si256(_mm256_load_si256(d), s));
+        }
+#else
+        for (size_t i = 0; i < words; ++i)
+            dst[i] |= src[i];
+#endif
+    }
+
+    // dst &= ~mask; returns whether any bit of dst is still set.
+    inline bool andNotInto(uint64_t* dst, const uint64_t* mask, size_t words)
+    {
+#ifdef __AVX2__
+        __m256i any = _mm256_setzero_si256();
+        for (size_t i = 0; i < words; i += 4)
+        {
+            __m256i* d = reinterpret_cast<__m256i*>(dst + i);
+            __m256i m = _mm256_load_si256(reinterpret_cast<const __m256i*>(mask + i));
+            __m256i r = _mm256_andnot_si256(m, _mm256_load_si256(d));
+            _mm256_store_si256(d, r);
+            any = _mm256_or_si256(any, r);
+        }
+        return !_mm256_testz_si256(any, any);
+#else
+        uint64_t any = 0;
+        for (size_t i = 0; i < words; ++i)
+        {
+            dst[i] &= ~mask[i];
+            any |= dst[i];
+        }
+        return any != 0;
+#endif
+    }
+}
+
+// Dense directed graph stored as an adjacency matrix with one bit per edge.
+// Every row is padded to a multiple of 512 bits and starts on a 64-byte
+// boundary, so one row is a whole number of cache lines / AVX2 registers.
+// Memory is n * ceil(n / 512) * 64 bytes: 512 MiB for 65536 vertices.
+class BitMatrixGraph
+{
+public:
+    explicit BitMatrixGraph(uint32_t vertex_count = 0);
+    BitMatrixGraph(const BitMatrixGraph& other);
+    BitMatrixGraph(BitMatrixGraph&& other) noexcept;
+    BitMatrixGraph& operator=(const BitMatrixGraph& other);
+    BitMatrixGraph& operator=(BitMatrixGraph&& other) noexcept;
+    ~BitMatrixGraph();
+
+    uint32_t vertexCount() const { return n; }
+    size_t wordsPerRow() const { return stride; }
+
+    void addEdge(uint32_t from, uint32_t to) { row(from)[to >> 6] |= bit(to); }
+    void removeEdge(uint32_t from, uint32_t to) { row(from)[to >> 6] &= ~bit(to); }
+    void addUndirectedEdge(uint32_t u, uint32_t v);
+    bool hasEdge(uint32_t from, uint32_t to) const { return row(from)[to >> 6] & bit(to); }
+
+    uint64_t outDegree(uint32_t v) const { return bitrow::popcount(row(v), stride); }
+    uint64_t commonNeighbors(uint32_t u, uint32_t v) const;
+
+    // Number of triangles of an undirected (symmetric) graph.
+    uint64_t countTriangles() const;
+
+    // Bit-parallel BFS: each level is the OR of the frontier rows minus the
+    // visited set. Returns -1 for unreachable vertices, like task 5.
+    std::vector<int> bfs(uint32_t source) const;
+
+    // reach.hasEdge(u, v) iff v is reachable from u (u reaches itself).
+    BitMatrixGraph transitiveClosure() const;
+
+    const uint64_t* row(uint32_t v) const { return bits + v * stride; }
+    uint64_t* row(uint32_t v) { return bits + v * stride; }
+
+private:
+    uint32_t n = 0;
+    size_t stride = 0; // words per row, multiple of 8
+    uint64_t* bits = nullptr;
+
+    static uint64_t bit(uint32_t v) { return uint64_t(1) << (v & 63); }
+
+    void allocate(uint32_t vertex_count);
+    void free();
+};
+
+inline BitMatrixGraph::BitMatrixGraph(uint32_t vertex_count)
+{
+    allocate(vertex_count);
+}
+
+inline BitMatrixGraph::BitMatrixGraph(const BitMatrixGraph& other)
+{
+    allocate(other.n);
+    std::memcpy(bits, other.bits, n * stride * sizeof(uint64_t));
+}
+
+inline BitMatrixGraph::BitMatrixGraph(BitMatrixGraph&& other) noexcept
+    : n(other.n), stride(other.stride), bits(other.bits)
+{
+    other.n = 0;
+    other.stride = 0;
+    other.bits = nullptr;
+}
+
+inline BitMatrixGraph& BitMatrixGraph::operator=(const BitMatrixGraph& other)
+{
+    if (this != &other)
+    {
+        BitMatrixGraph copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+inline BitMatrixGraph& BitMatrixGraph::operator=(BitMatrixGraph&& other) noexcept
+{
+    if (this != &other)
+    {
+        free();
+        std::swap(n, other.n);
+        std::swap(stride, other.stride);
+        std::swap(bits, other.bits);
+    }
+    return *this;
+}
+
+inline BitMatrixGraph::~BitMatrixGraph()
+{
+    free();
+}
+
+inline void BitMatrixGraph::allocate(uint32_t vertex_count)
+{
+    n = vertex_count;
+    stride = (static_cast<size_t>(vertex_count) + 511) / 512 * 8;
+    size_t bytes = n * stride * sizeof(uint64_t);
+    if (bytes == 0)
+        return;
+
+    bits = static_cast<uint64_t*>(std::aligned_alloc(64, bytes));
+    if (!bits)
+        throw std::bad_alloc();
+    std::memset(bits, 0, bytes);
+}
+
+inline void BitMatrixGraph::free()
+{
+    std::free(bits);
+    bits = nullptr;
+    n = 0;
+    stride = 0;
+}
+
+inline void BitMatrixGraph::addUndirectedEdge(uint32_t u, uint32_t v)
+{
+    addEdge(u, v);
+    addEdge(v, u);
+}
+
+inline uint64_t BitMatrixGraph::commonNeighbors(uint32_t u, uint32_t v) const
+{
+    return bitrow::popcountAnd(row(u), row(v), stride);
+}
+
+inline uint64_t BitMatrixGraph::countTriangles() const
+{
+    // Every triangle {u, v, w} is found once per edge, i.e. three times.
+    uint64_t total = 0;
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        const uint64_t* row_u = row(u);
+        for (size_t word = (u + 1) >> 6; word < stride; ++word)
+        {
+            uint64_t neighbors = row_u[word];
+            if (word == ((u + 1) >> 6))
+                neighbors &= ~uint64_t(0) << ((u + 1) & 63);
+
+            while (neighbors)
+            {
+                uint32_t v = static_cast<uint32_t>(word * 64 + __builtin_ctzll(neighbors));
+                neighbors &= neighbors - 1;
+                total += bitrow::popcountAnd(row_u, row(v), stride);
+            }
+        }
+    }
+    return total / 3;
+}
+
+inline std::vector<int> BitMatrixGraph::bfs(uint32_t source) const
+{
+    std::vector<int> distance(n, -1);
+    if (source >= n)
+        return distance;
+
+    uint64_t* buffers = static_cast<uint64_t*>(std::aligned_alloc(64, 3 * stride * sizeof(uint64_t)));
+    if (!buffers)
+        throw std::bad_alloc();
+    std::memset(buffers, 0, 3 * stride * sizeof(uint64_t));
+    uint64_t* visited = buffers;
+    uint64_t* frontier = buffers + stride;
+    uint64_t* next = buffers + 2 * stride;
+
+    visited[source >> 6] |= bit(source);
+    frontier[source >> 6] |= bit(source);
+    distance[source] = 0;
+
+    for (int level = 1;; ++level)
+    {
+        std::memset(next, 0, stride * sizeof(uint64_t));
+        for (size_t word = 0; word < stride; ++word)
+        {
+            for (uint64_t w = frontier[word]; w; w &= w - 1)
+                bitrow::orInto(next, row(static_cast<uint32_t>(word * 64 + __builtin_ctzll(w))), stride);
+        }
+
+        if (!bitrow::andNotInto(next, visited, stride))
+            break;
+
+        bitrow::orInto(visited, next, stride);
+        for (size_t word = 0; word < stride; ++word)
+        {
+            for (uint64_t w = next[word]; w; w &= w - 1)
+                distance[word * 64 + __builtin_ctzll(w)] = level;
+        }
+        std::swap(frontier, next);
+    }
+
+    std::free(buffers);
+    return distance;
+}
+
+inline BitMatrixGraph BitMatrixGraph::transitiveClosure() const
+{
+    // Warshall's algorithm with whole-row ORs: n^3 / 256 AVX2 operations.
+    BitMatrixGraph reach(*this);
+    for (uint32_t v = 0; v < n; ++v)
+        reach.addEdge(v, v);
+
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        const uint64_t* row_k = reach.row(k);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (i != k && reach.hasEdge(i, k))
+                bitrow::orInto(reach.row(i), row_k, stride);
+        }
+    }
+    return reach;
+}
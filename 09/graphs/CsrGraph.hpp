@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Compressed sparse row adjacency. The neighbours of vertex v are stored in
+// adjacency[offsets[v]] .. adjacency[offsets[v + 1] - 1], so the whole graph
+// lives in two flat arrays instead of one hash set per vertex.
+struct CsrGraph
+{
+    uint32_t vertex_count = 0;
+    std::vector<uint64_t> offsets; // vertex_count + 1 entries
+    std::vector<uint32_t> adjacency;
+
+    uint64_t edgeCount() const { return adjacency.size(); }
+
+    uint32_t degree(uint32_t v) const
+    {
+        return static_cast<uint32_t>(offsets[v + 1] - offsets[v]);
+    }
+
+    const uint32_t* neighborsBegin(uint32_t v) const { return adjacency.data() + offsets[v]; }
+    const uint32_t* neighborsEnd(uint32_t v) const { return adjacency.data() + offsets[v + 1]; }
+
+    // Builds the CSR with a count-then-fill pass over the edge list. For an
+    // undirected graph every edge is stored in both directions.
+    static CsrGraph fromEdges(uint32_t vertex_count,
+                              const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                              bool undirected = true);
+};
+
+inline CsrGraph CsrGraph::fromEdges(uint32_t vertex_count,
+                                    const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                                    bool undirected)
+{
+    CsrGraph graph;
+    graph.vertex_count = vertex_count;
+    graph.offsets.assign(static_cast<size_t>(vertex_count) + 1, 0);
+
+    for (const auto& edge : edges)
+    {
+        graph.offsets[edge.first + 1]++;
+        if (undirected)
+            graph.offsets[edge.second + 1]++;
+    }
+
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        graph.offsets[v + 1] += graph.offsets[v];
+
+    graph.adjacency.resize(graph.offsets[vertex_count]);
+    std::vector<uint64_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+
+    for (const auto& edge : edges)
+    {
+        graph.adjacency[cursor[edge.first]++] = edge.second;
+        if (undirected)
+            graph.adjacency[cursor[edge.second]++] = edge.first;
+    }
+
+    return graph;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Union-find with union by size and path halving: near-constant time per
+// operation, but sets can only grow.
+class DisjointSet
+{
+public:
+    explicit DisjointSet(uint32_t count = 0) { reset(count); }
+
+    void reset(uint32_t count)
+    {
+        parent.resize(count);
+        std::iota(parent.begin(), parent.end(), 0u);
+        size.assign(count, 1);
+        sets = count;
+    }
+
+    uint32_t find(uint32_t x)
+    {
+        while (parent[x] != x)
+        {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // false if a and b were already in the same set.
+    bool unite(uint32_t a, uint32_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return false;
+        if (size[a] < size[b])
+            std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        sets--;
+        return true;
+    }
+
+    uint32_t setSize(uint32_t x) { return size[find(x)]; }
+    uint32_t setCount() const { return sets; }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> size;
+    uint32_t sets = 0;
+};
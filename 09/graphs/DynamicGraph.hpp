@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct EdgeUpdate
+{
+    uint32_t u;
+    uint32_t v;
+    bool insert; // false = delete one copy of the edge
+};
+
+// Undirected graph under edge insertions / deletions that keeps its
+// connected components up to date, so "is there a path between A and B"
+// (task 4) is an O(1) label comparison instead of a fresh traversal.
+//
+// Every vertex carries a component label and every label a member list.
+// Inserting an edge between two components relabels the smaller one
+// (small-to-large, O(log n) amortised moves per vertex). A union-find
+// cannot be split again, which is why labels are explicit.
+//
+// Deletions use a connectivity certificate: a set of edges that connects
+// every component. Deleting an edge outside the certificate cannot
+// disconnect anything. Deleting a certificate edge (u, v) starts two BFS
+// searches from u and v, always expanding the one with fewer pending
+// vertices:
+//   - they meet: still connected, the found u..v path joins the certificate;
+//   - one side runs out first: that side is the split-off (smaller) piece
+//     and only its vertices are relabelled.
+// Found paths only ever add edges, so once the certificate holds more than
+// 2(n - 1) of them it is replaced by a BFS spanning forest of the graph
+// (n - 1 edges at most). Otherwise it drifts towards the whole edge set and
+// nearly every deletion pays for a search.
+class DynamicGraph
+{
+public:
+    explicit DynamicGraph(uint32_t vertex_count);
+
+    void applyBatch(const std::vector<EdgeUpdate>& updates);
+    void insertEdge(uint32_t u, uint32_t v);
+    void removeEdge(uint32_t u, uint32_t v);
+
+    bool connected(uint32_t u, uint32_t v) const { return label[u] == label[v]; }
+    uint32_t componentSize(uint32_t v) const { return static_cast<uint32_t>(members[label[v]].size()); }
+    uint32_t componentCount() const { return components; }
+
+    uint32_t vertexCount() const { return static_cast<uint32_t>(adjacency.size()); }
+    uint64_t edgeCount() const { return edge_count; }
+    const std::vector<uint32_t>& neighbors(uint32_t v) const { return adjacency[v]; }
+
+    // Vertices visited by deletion searches so far.
+    uint64_t searchedVertices() const { return searched_vertices; }
+    uint64_t certificateSize() const { return certificate.size(); }
+
+private:
+    std::vector<std::vector<uint32_t>> adjacency;
+    std::unordered_map<uint64_t, uint32_t> multiplicity;
+    std::unordered_set<uint64_t> certificate;
+
+    std::vector<uint32_t> label;                 // component label per vertex
+    std::vector<uint32_t> position;              // index inside members[label]
+    std::vector<std::vector<uint32_t>> members;  // vertices per label
+    std::vector<uint32_t> free_labels;
+    uint32_t components = 0;
+    uint64_t edge_count = 0;
+    uint64_t searched_vertices = 0;
+
+    // Deletion search state, reset lazily through epochs.
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> parent;
+    uint32_t epoch = 0;
+
+    static uint64_t key(uint32_t u, uint32_t v)
+    {
+        if (u > v)
+            std::swap(u, v);
+        return (uint64_t(u) << 32) | v;
+    }
+
+    void eraseNeighbor(uint32_t v, uint32_t neighbor);
+    void merge(uint32_t a, uint32_t b);
+    void split(const std::vector<uint32_t>& piece);
+    void reconnect(uint32_t u, uint32_t v);
+    void addPath(uint32_t from);
+    void rebuildCertificate();
+    uint32_t nextEpoch();
+};
+
+inline DynamicGraph::DynamicGraph(uint32_t vertex_count)
+    : adjacency(vertex_count),
+      label(vertex_count),
+      position(vertex_count, 0),
+      members(vertex_count),
+      components(vertex_count),
+      stamp(vertex_count, 0),
+      parent(vertex_count, 0)
+{
+    std::iota(label.begin(), label.end(), 0u);
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        members[v].push_back(v);
+}
+
+inline void DynamicGraph::applyBatch(const std::vector<EdgeUpdate>& updates)
+{
+    for (const EdgeUpdate& update : updates)
+    {
+        if (update.insert)
+            insertEdge(update.u, update.v);
+        else
+            removeEdge(update.u, update.v);
+    }
+}
+
+inline void DynamicGraph::insertEdge(uint32_t u, uint32_t v)
+{
+    multiplicity[key(u, v)]++;
+    adjacency[u].push_back(v);
+    if (u != v)
+        adjacency[v].push_back(u);
+    edge_count++;
+
+    if (label[u] != label[v])
+    {
+        merge(label[u], label[v]);
+        certificate.insert(key(u, v));
+    }
+}
+
+inline void DynamicGraph::removeEdge(uint32_t u, uint32_t v)
+{
+    uint64_t k = key(u, v);
+    auto it = multiplicity.find(k);
+    if (it == multiplicity.end())
+        return;
+
+    eraseNeighbor(u, v);
+    if (u != v)
+        eraseNeighbor(v, u);
+    edge_count--;
+
+    if (--it->second > 0)
+        return;
+    multiplicity.erase(it);
+
+    if (certificate.erase(k))
+        reconnect(u, v);
+}
+
+inline void DynamicGraph::eraseNeighbor(uint32_t v, uint32_t neighbor)
+{
+    std::vector<uint32_t>& list = adjacency[v];
+    auto it = std::find(list.begin(), list.end(), neighbor);
+    *it = list.back();
+    list.pop_back();
+}
+
+inline void DynamicGraph::merge(uint32_t a, uint32_t b)
+{
+    if (members[a].size() < members[b].size())
+        std::swap(a, b);
+
+    std::vector<uint32_t>& big = members[a];
+    for (uint32_t w : members[b])
+    {
+        label[w] = a;
+        position[w] = static_cast<uint32_t>(big.size());
+        big.push_back(w);
+    }
+    members[b].clear();
+    members[b].shrink_to_fit();
+    free_labels.push_back(b);
+    components--;
+}
+
+inline void DynamicGraph::split(const std::vector<uint32_t>& piece)
+{
+    uint32_t old_label = label[piece.front()];
+    uint32_t new_label = free_labels.back();
+    free_labels.pop_back();
+
+    std::vector<uint32_t>& old_members = members[old_label];
+    for (uint32_t w : piece)
+    {
+        uint32_t last = old_members.back();
+        old_members[position[w]] = last;
+        position[last] = position[w];
+        old_members.pop_back();
+
+        label[w] = new_label;
+        position[w] = static_cast<uint32_t>(members[new_label].size());
+        members[new_label].push_back(w);
+    }
+    components++;
+}
+
+// Walks BFS parents back to the search root, adding each edge to the
+// certificate.
+inline void DynamicGraph::addPath(uint32_t from)
+{
+    while (parent[from] != from)
+    {
+        certificate.insert(key(from, parent[from]));
+        from = parent[from];
+    }
+}
+
+// Two fresh stamp values, epoch and epoch + 1.
+inline uint32_t DynamicGraph::nextEpoch()
+{
+    epoch += 2;
+    if (epoch < 2)
+    {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 2;
+    }
+    return epoch;
+}
+
+inline void DynamicGraph::rebuildCertificate()
+{
+    certificate.clear();
+    uint32_t mark = nextEpoch();
+    std::vector<uint32_t> queue;
+    for (uint32_t root = 0; root < vertexCount(); ++root)
+    {
+        if (stamp[root] == mark)
+            continue;
+        stamp[root] = mark;
+        queue.assign(1, root);
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            uint32_t current = queue[head];
+            for (uint32_t neighbor : adjacency[current])
+            {
+                if (stamp[neighbor] != mark)
+                {
+                    stamp[neighbor] = mark;
+                    certificate.insert(key(current, neighbor));
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    }
+}
+
+inline void DynamicGraph::reconnect(uint32_t u, uint32_t v)
+{
+    // stamp == epoch: reached from u, stamp == epoch + 1: reached from v.
+    nextEpoch();
+
+    std::vector<uint32_t> side[2] = {{u}, {v}};
+    size_t head[2] = {0, 0};
+    stamp[u] = epoch;
+    stamp[v] = epoch + 1;
+    parent[u] = u;
+    parent[v] = v;
+
+    for (;;)
+    {
+        // Expand the side with the smaller pending queue; an exhausted side
+        // (nothing pending) is always picked first.
+        int s = side[0].size() - head[0] <= side[1].size() - head[1] ? 0 : 1;
+        if (head[s] == side[s].size())
+        {
+            searched_vertices += side[0].size() + side[1].size();
+            split(side[s]);
+            return;
+        }
+
+        uint32_t current = side[s][head[s]++];
+        for (uint32_t neighbor : adjacency[current])
+        {
+            if (stamp[neighbor] == epoch + (s ^ 1))
+            {
+                searched_vertices += side[0].size() + side[1].size();
+                certificate.insert(key(current, neighbor));
+                addPath(current);
+                addPath(neighbor);
+                if (certificate.size() > 2 * uint64_t(vertexCount()))
+                    rebuildCertificate();
+                return;
+            }
+            if (stamp[neighbor] != epoch + s)
+            {
+                stamp[neighbor] = epoch + s;
+                parent[neighbor] = current;
+                side[s].push_back(neighbor);
+            }
+        }
+    }
+}
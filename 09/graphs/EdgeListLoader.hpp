@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CsrGraph.hpp"
+
+// Read-only memory mapping of a whole file. The kernel pages the file in on
+// demand, so parsing threads read straight from the page cache without the
+// extra copy (and locale machinery) of an ifstream.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+
+private:
+    int fd = -1;
+    char* begin = nullptr;
+    size_t length = 0;
+};
+
+inline MappedFile::MappedFile(const std::string& path)
+{
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0)
+        return;
+
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot mmap " + path);
+    }
+
+    begin = static_cast<char*>(mapped);
+    ::madvise(begin, length, MADV_SEQUENTIAL);
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (begin)
+        ::munmap(begin, length);
+    if (fd >= 0)
+        ::close(fd);
+}
+
+struct EdgeListOptions
+{
+    unsigned threads = 0;        // 0 means std::thread::hardware_concurrency()
+    bool undirected = true;      // store every edge in both directions
+    bool one_based = true;       // task inputs number vertices from 1 to N
+    bool sort_neighbors = false; // parallel fill leaves rows in arbitrary order
+};
+
+struct EdgeListStats
+{
+    uint64_t bytes = 0;
+    uint64_t edges = 0;
+    double count_seconds = 0; // parse pass 1: degree counting
+    double fill_seconds = 0;  // parse pass 2: adjacency fill
+    double total_seconds = 0; // file bytes -> finished CsrGraph
+
+    // Both passes read the whole file.
+    double countGigabytesPerSecond() const
+    {
+        return count_seconds > 0 ? bytes / count_seconds / 1e9 : 0;
+    }
+    double fillGigabytesPerSecond() const
+    {
+        return fill_seconds > 0 ? bytes / fill_seconds / 1e9 : 0;
+    }
+};
+
+namespace detail
+{
+    inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    // Hand-rolled decimal parser. Returns nullptr if no digit follows the
+    // leading blanks or the number does not fit in Unsigned, otherwise the
+    // position right after the number.
+    template <typename Unsigned>
+    inline const char* parseUnsigned(const char* p, const char* end, Unsigned& value)
+    {
+        while (p < end && isBlank(*p))
+            ++p;
+        if (p == end || static_cast<unsigned>(*p - '0') > 9)
+            return nullptr;
+
+        Unsigned result = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') <= 9)
+        {
+            if (__builtin_mul_overflow(result, Unsigned(10), &result) ||
+                __builtin_add_overflow(result, Unsigned(*p - '0'), &result))
+                return nullptr;
+            ++p;
+        }
+        value = result;
+        return p;
+    }
+
+    // True if the line starting at p holds only blanks.
+    inline bool isBlankLine(const char* p, const char* end)
+    {
+        while (p < end && isBlank(*p))
+            ++p;
+        return p == end || *p == '\n';
+    }
+
+    inline const char* nextLine(const char* p, const char* end)
+    {
+        const void* newline = std::memchr(p, '\n', end - p);
+        return newline ? static_cast<const char*>(newline) + 1 : end;
+    }
+
+    // Calls visit(u, v) for the first two numbers of every line in
+    // [p, end). Extra columns (e.g. weights) are ignored, blank lines are
+    // skipped. Returns false on a malformed line.
+    template <typename Visitor>
+    bool forEachEdge(const char* p, const char* end, Visitor&& visit)
+    {
+        while (p < end)
+        {
+            uint32_t u, v;
+            const char* q = parseUnsigned(p, end, u);
+            if (!q)
+            {
+                while (p < end && isBlank(*p))
+                    ++p;
+                if (p < end && *p != '\n')
+                    return false;
+                p = p < end ? p + 1 : end;
+                continue;
+            }
+
+            q = parseUnsigned(q, end, v);
+            if (!q || !visit(u, v))
+                return false;
+            p = nextLine(q, end);
+        }
+        return true;
+    }
+
+    // Runs work(0) .. work(count - 1) on separate threads, the first one on
+    // the calling thread.
+    template <typename Work>
+    void runParallel(unsigned count, Work&& work)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(count > 0 ? count - 1 : 0);
+        for (unsigned i = 1; i < count; ++i)
+            workers.emplace_back([&work, i]() { work(i); });
+        work(0);
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    inline double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+// Parses "N M" followed by M lines "u v" from an in-memory buffer. Anything
+// after the M-th edge line (the query part of a task input) is ignored.
+inline CsrGraph parseEdgeList(const char* begin, const char* end,
+                              const EdgeListOptions& options = EdgeListOptions(),
+                              EdgeListStats* stats = nullptr)
+{
+    using namespace detail;
+    auto start = std::chrono::steady_clock::now();
+
+    uint32_t vertex_count = 0;
+    uint64_t edge_count = 0;
+    const char* p = parseUnsigned(begin, end, vertex_count);
+    if (p)
+        p = parseUnsigned(p, end, edge_count);
+    if (!p)
+        throw std::runtime_error("Edge list must start with \"N M\"");
+    const char* body = nextLine(p, end);
+
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>((end - body) / 4096 + 1)));
+
+    // Chunk boundaries are snapped forward to the next line start, so every
+    // line belongs to exactly one chunk.
+    std::vector<const char*> bounds(threads + 1);
+    bounds[0] = body;
+    bounds[threads] = end;
+    for (unsigned i = 1; i < threads; ++i)
+        bounds[i] = std::max(bounds[i - 1], nextLine(body + (end - body) * i / threads - 1, end));
+
+    // Cut the body after M edge lines so trailing query lines are not read
+    // as edges. Blank lines are skipped by forEachEdge, so they do not count.
+    std::vector<uint64_t> lines(threads, 0);
+    runParallel(threads, [&](unsigned i) {
+        for (const char* q = bounds[i]; q < bounds[i + 1]; q = nextLine(q, bounds[i + 1]))
+            lines[i] += !isBlankLine(q, bounds[i + 1]);
+    });
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        if (seen + lines[i] <= edge_count)
+        {
+            seen += lines[i];
+            continue;
+        }
+        const char* q = bounds[i];
+        while (seen < edge_count)
+        {
+            seen += !isBlankLine(q, bounds[i + 1]);
+            q = nextLine(q, bounds[i + 1]);
+        }
+        for (unsigned j = i + 1; j <= threads; ++j)
+            bounds[j] = q;
+        break;
+    }
+
+    const uint32_t base = options.one_based ? 1 : 0;
+    const bool undirected = options.undirected;
+    std::unique_ptr<std::atomic<uint64_t>[]> cursor(new std::atomic<uint64_t>[vertex_count]);
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        cursor[v].store(0, std::memory_order_relaxed);
+
+    std::vector<uint64_t> parsed(threads, 0);
+    std::vector<char> failed(threads, 0);
+
+    // Pass 1: count degrees.
+    auto pass_start = std::chrono::steady_clock::now();
+    runParallel(threads, [&](unsigned i) {
+        uint64_t local = 0;
+        bool ok = forEachEdge(bounds[i], bounds[i + 1], [&](uint32_t u, uint32_t v) {
+            u -= base;
+            v -= base;
+            if (u >= vertex_count || v >= vertex_count)
+                return false;
+            cursor[u].fetch_add(1, std::memory_order_relaxed);
+            if (undirected)
+                cursor[v].fetch_add(1, std::memory_order_relaxed);
+            local++;
+            return true;
+        });
+        parsed[i] = local;
+        failed[i] = !ok;
+    });
+    double count_seconds = secondsSince(pass_start);
+
+    uint64_t total_edges = 0;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        if (failed[i])
+            throw std::runtime_error("Malformed edge line or vertex out of range");
+        total_edges += parsed[i];
+    }
+    if (total_edges != edge_count)
+        throw std::runtime_error("Expected " + std::to_string(edge_count) + " edges, found " +
+                                 std::to_string(total_edges));
+
+    CsrGraph graph;
+    graph.vertex_count = vertex_count;
+    graph.offsets.resize(static_cast<size_t>(vertex_count) + 1);
+    graph.offsets[0] = 0;
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        uint64_t degree = cursor[v].load(std::memory_order_relaxed);
+        graph.offsets[v + 1] = graph.offsets[v] + degree;
+        cursor[v].store(graph.offsets[v], std::memory_order_relaxed);
+    }
+    graph.adjacency.resize(graph.offsets[vertex_count]);
+
+    // Pass 2: parse again and drop every neighbour into its reserved slot.
+    pass_start = std::chrono::steady_clock::now();
+    uint32_t* adjacency = graph.adjacency.data();
+    runParallel(threads, [&](unsigned i) {
+        forEachEdge(bounds[i], bounds[i + 1], [&](uint32_t u, uint32_t v) {
+            u -= base;
+            v -= base;
+            adjacency[cursor[u].fetch_add(1, std::memory_order_relaxed)] = v;
+            if (undirected)
+                adjacency[cursor[v].fetch_add(1, std::memory_order_relaxed)] = u;
+            return true;
+        });
+    });
+    double fill_seconds = secondsSince(pass_start);
+
+    if (options.sort_neighbors)
+    {
+        runParallel(threads, [&](unsigned i) {
+            uint32_t first = static_cast<uint32_t>(uint64_t(vertex_count) * i / threads);
+            uint32_t last = static_cast<uint32_t>(uint64_t(vertex_count) * (i + 1) / threads);
+            for (uint32_t v = first; v < last; ++v)
+                std::sort(adjacency + graph.offsets[v], adjacency + graph.offsets[v + 1]);
+        });
+    }
+
+    if (stats)
+    {
+        stats->bytes = static_cast<uint64_t>(bounds[threads] - body);
+        stats->edges = total_edges;
+        stats->count_seconds = count_seconds;
+        stats->fill_seconds = fill_seconds;
+        stats->total_seconds = secondsSince(start);
+    }
+    return graph;
+}
+
+inline CsrGraph loadEdgeList(const std::string& path,
+                             const EdgeListOptions& options = EdgeListOptions(),
+                             EdgeListStats* stats = nullptr)
+{
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    CsrGraph graph = parseEdgeList(file.data(), file.data() + file.size(), options, stats);
+    if (stats)
+        stats->total_seconds = detail::secondsSince(start);
+    return graph;
+}
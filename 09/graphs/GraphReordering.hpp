@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "CsrGraph.hpp"
+
+// Vertex relabelling for traversal locality. Every ordering returns a
+// permutation new_id[old vertex] -> new vertex; relabel() applies it to a
+// CsrGraph and mapBack() translates per-vertex results of the relabelled
+// graph back to the original IDs.
+
+inline std::vector<uint32_t> invertPermutation(const std::vector<uint32_t>& new_id)
+{
+    std::vector<uint32_t> old_id(new_id.size());
+    for (uint32_t v = 0; v < new_id.size(); ++v)
+        old_id[new_id[v]] = v;
+    return old_id;
+}
+
+// Turns a visiting order (list of old IDs) into new_id.
+inline std::vector<uint32_t> orderToPermutation(const std::vector<uint32_t>& order)
+{
+    return invertPermutation(order);
+}
+
+// High-degree vertices first, so the hubs touched by most traversals share
+// the first cache lines of every per-vertex array.
+inline std::vector<uint32_t> degreeOrder(const CsrGraph& graph)
+{
+    std::vector<uint32_t> order(graph.vertex_count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&graph](uint32_t a, uint32_t b) {
+        return graph.degree(a) > graph.degree(b);
+    });
+    return orderToPermutation(order);
+}
+
+// BFS discovery order, one component after another: vertices of the same
+// BFS level get consecutive IDs.
+inline std::vector<uint32_t> bfsOrder(const CsrGraph& graph)
+{
+    std::vector<uint32_t> order;
+    order.reserve(graph.vertex_count);
+    std::vector<bool> visited(graph.vertex_count, false);
+
+    for (uint32_t start = 0; start < graph.vertex_count; ++start)
+    {
+        if (visited[start])
+            continue;
+        visited[start] = true;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head)
+        {
+            uint32_t current = order[head];
+            for (const uint32_t* n = graph.neighborsBegin(current); n != graph.neighborsEnd(current); ++n)
+            {
+                if (!visited[*n])
+                {
+                    visited[*n] = true;
+                    order.push_back(*n);
+                }
+            }
+        }
+    }
+    return orderToPermutation(order);
+}
+
+// Reverse Cuthill-McKee: BFS from a low-degree peripheral vertex of every
+// component, visiting neighbours by increasing degree, then reverse the
+// whole order. Minimises the bandwidth |new_id[u] - new_id[v]| of edges.
+inline std::vector<uint32_t> reverseCuthillMcKee(const CsrGraph& graph)
+{
+    const uint32_t n = graph.vertex_count;
+    std::vector<uint32_t> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0u);
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&graph](uint32_t a, uint32_t b) {
+        return graph.degree(a) < graph.degree(b);
+    });
+
+    std::vector<uint32_t> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    std::vector<uint32_t> level(n, 0);
+    std::vector<uint32_t> scratch;
+
+    // Pseudo-peripheral start: repeatedly jump to the lowest-degree vertex
+    // of the last BFS level while the eccentricity keeps growing.
+    std::vector<uint32_t> probe_stamp(n, 0);
+    uint32_t probe = 0;
+    auto farthestLowDegree = [&](uint32_t root, uint32_t& eccentricity) {
+        ++probe;
+        scratch.assign(1, root);
+        probe_stamp[root] = probe;
+        level[root] = 0;
+        for (size_t head = 0; head < scratch.size(); ++head)
+        {
+            uint32_t current = scratch[head];
+            for (const uint32_t* nb = graph.neighborsBegin(current); nb != graph.neighborsEnd(current); ++nb)
+            {
+                if (probe_stamp[*nb] != probe)
+                {
+                    probe_stamp[*nb] = probe;
+                    level[*nb] = level[current] + 1;
+                    scratch.push_back(*nb);
+                }
+            }
+        }
+        eccentricity = level[scratch.back()];
+        uint32_t best = scratch.back();
+        for (auto it = scratch.rbegin(); it != scratch.rend() && level[*it] == eccentricity; ++it)
+        {
+            if (graph.degree(*it) < graph.degree(best))
+                best = *it;
+        }
+        return best;
+    };
+
+    std::vector<uint32_t> neighbors;
+    for (uint32_t candidate : by_degree)
+    {
+        if (visited[candidate])
+            continue;
+
+        uint32_t start = candidate, eccentricity = 0;
+        for (int round = 0; round < 4; ++round)
+        {
+            uint32_t previous = eccentricity;
+            uint32_t next = farthestLowDegree(start, eccentricity);
+            if (round > 0 && eccentricity <= previous)
+                break;
+            start = next;
+        }
+
+        visited[start] = true;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head)
+        {
+            uint32_t current = order[head];
+            neighbors.clear();
+            for (const uint32_t* nb = graph.neighborsBegin(current); nb != graph.neighborsEnd(current); ++nb)
+            {
+                if (!visited[*nb])
+                {
+                    visited[*nb] = true;
+                    neighbors.push_back(*nb);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(), [&graph](uint32_t a, uint32_t b) {
+                return graph.degree(a) < graph.degree(b);
+            });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return orderToPermutation(order);
+}
+
+// Builds the graph with every vertex v renamed to new_id[v]. Rows are
+// sorted so neighbour scans walk memory forward.
+inline CsrGraph relabel(const CsrGraph& graph, const std::vector<uint32_t>& new_id)
+{
+    const std::vector<uint32_t> old_id = invertPermutation(new_id);
+
+    CsrGraph result;
+    result.vertex_count = graph.vertex_count;
+    result.offsets.resize(static_cast<size_t>(graph.vertex_count) + 1);
+    result.adjacency.resize(graph.adjacency.size());
+
+    result.offsets[0] = 0;
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+        result.offsets[v + 1] = result.offsets[v] + graph.degree(old_id[v]);
+
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        uint32_t* out = result.adjacency.data() + result.offsets[v];
+        uint32_t old = old_id[v];
+        for (const uint32_t* n = graph.neighborsBegin(old); n != graph.neighborsEnd(old); ++n)
+            *out++ = new_id[*n];
+        std::sort(result.adjacency.data() + result.offsets[v], out);
+    }
+    return result;
+}
+
+// values[new vertex] -> result[old vertex].
+template <typename T>
+std::vector<T> mapBack(const std::vector<T>& values, const std::vector<uint32_t>& new_id)
+{
+    std::vector<T> result(values.size());
+    for (uint32_t v = 0; v < new_id.size(); ++v)
+        result[v] = values[new_id[v]];
+    return result;
+}
+
+// Sum over edges of |new_id[u] - new_id[v]|, divided by the edge count.
+inline double averageEdgeSpan(const CsrGraph& graph)
+{
+    if (graph.adjacency.empty())
+        return 0;
+    double total = 0;
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        for (const uint32_t* n = graph.neighborsBegin(v); n != graph.neighborsEnd(v); ++n)
+            total += *n > v ? *n - v : v - *n;
+    }
+    return total / graph.adjacency.size();
+}
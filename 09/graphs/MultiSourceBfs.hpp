@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "CsrGraph.hpp"
+
+// Multi-source BFS (MS-BFS): runs up to 64 * Words breadth-first searches at
+// once. Every vertex keeps one bit per source ("lane") in its seen / visit
+// masks, so a single scan of a vertex's adjacency advances all searches that
+// are currently at that vertex.
+//
+// The scratch masks are allocated once per graph and reused for every batch,
+// instead of a fresh queue and visited set per source as in bfs.cpp.
+template <size_t Words = 1>
+class MultiSourceBfs
+{
+public:
+    static constexpr size_t LANES = 64 * Words;
+    using Mask = std::array<uint64_t, Words>;
+
+    explicit MultiSourceBfs(const CsrGraph& graph);
+
+    // Runs one batch of at most LANES sources. visitor(vertex, lane, distance)
+    // is called once for every vertex reached by sources[lane], including the
+    // source itself at distance 0.
+    template <typename Visitor>
+    void run(const uint32_t* sources, size_t count, Visitor&& visitor);
+
+    // Splits any number of sources into batches and returns, for every
+    // source, the sum of distances to the vertices it reaches.
+    std::vector<uint64_t> distanceSums(const std::vector<uint32_t>& sources);
+
+private:
+    const CsrGraph& graph;
+    std::vector<Mask> seen;
+    std::vector<Mask> visit;
+    std::vector<Mask> next;
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> touched;
+
+    static bool any(const Mask& mask);
+};
+
+template <size_t Words>
+MultiSourceBfs<Words>::MultiSourceBfs(const CsrGraph& graph)
+    : graph(graph), seen(graph.vertex_count), visit(graph.vertex_count), next(graph.vertex_count)
+{
+    frontier.reserve(graph.vertex_count);
+    touched.reserve(graph.vertex_count);
+}
+
+template <size_t Words>
+bool MultiSourceBfs<Words>::any(const Mask& mask)
+{
+    uint64_t bits = 0;
+    for (size_t w = 0; w < Words; ++w)
+        bits |= mask[w];
+    return bits != 0;
+}
+
+template <size_t Words>
+template <typename Visitor>
+void MultiSourceBfs<Words>::run(const uint32_t* sources, size_t count, Visitor&& visitor)
+{
+    if (count > LANES)
+        throw std::invalid_argument("MultiSourceBfs batch is larger than the lane count");
+
+    frontier.clear();
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        uint32_t s = sources[lane];
+        if (!any(visit[s]))
+            frontier.push_back(s);
+        seen[s][lane >> 6] |= uint64_t(1) << (lane & 63);
+        visit[s][lane >> 6] |= uint64_t(1) << (lane & 63);
+        visitor(s, static_cast<uint32_t>(lane), 0);
+    }
+
+    for (int level = 1; !frontier.empty(); ++level)
+    {
+        // Push every frontier vertex's lanes to all its neighbours.
+        touched.clear();
+        for (uint32_t v : frontier)
+        {
+            const Mask& lanes = visit[v];
+            for (const uint32_t* n = graph.neighborsBegin(v); n != graph.neighborsEnd(v); ++n)
+            {
+                Mask& target = next[*n];
+                if (!any(target))
+                    touched.push_back(*n);
+                for (size_t w = 0; w < Words; ++w)
+                    target[w] |= lanes[w];
+            }
+            visit[v] = Mask();
+        }
+
+        // Keep only lanes that have not seen the vertex yet; they become the
+        // next frontier.
+        frontier.clear();
+        for (uint32_t v : touched)
+        {
+            Mask fresh;
+            for (size_t w = 0; w < Words; ++w)
+            {
+                fresh[w] = next[v][w] & ~seen[v][w];
+                seen[v][w] |= fresh[w];
+            }
+            next[v] = Mask();
+            if (!any(fresh))
+                continue;
+
+            visit[v] = fresh;
+            frontier.push_back(v);
+            for (size_t w = 0; w < Words; ++w)
+            {
+                for (uint64_t bits = fresh[w]; bits; bits &= bits - 1)
+                    visitor(v, static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)), level);
+            }
+        }
+    }
+
+    // Only seen still holds bits; clear it for the next batch.
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+        seen[v] = Mask();
+}
+
+template <size_t Words>
+std::vector<uint64_t> MultiSourceBfs<Words>::distanceSums(const std::vector<uint32_t>& sources)
+{
+    std::vector<uint64_t> sums(sources.size(), 0);
+    for (size_t first = 0; first < sources.size(); first += LANES)
+    {
+        size_t count = std::min(LANES, sources.size() - first);
+        uint64_t* batch_sums = sums.data() + first;
+        run(sources.data() + first, count, [batch_sums](uint32_t, uint32_t lane, int distance) {
+            batch_sums[lane] += distance;
+        });
+    }
+    return sums;
+}
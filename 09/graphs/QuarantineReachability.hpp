@@ -0,0 +1,462 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "DisjointSet.hpp"
+
+struct BlockEvent
+{
+    uint32_t vertex;
+    bool block; // false = unblock
+};
+
+// Connected components of the unblocked ("safe") servers of a fixed network
+// while servers are blocked and unblocked (task 9). "Is Y reachable from X"
+// and "how big is X's island" are O(1) label lookups instead of a BFS over
+// the whole network after every change.
+//
+// Labels, member lists and small-to-large relabelling follow DynamicGraph.
+//
+// Blocking v can split its island into up to deg(v) pieces. One BFS starts
+// from every unblocked neighbour of v and the searches advance round-robin.
+// Searches that touch each other belong to the same piece and are united.
+// As soon as at most one group of searches is still running, every finished
+// group is a complete piece and gets a new label; the running group keeps
+// the old label without being explored to the end. The work is bounded by
+// the degree times the size of the pieces that split off, not by the size
+// of the island.
+//
+// A batch applies only its net effect per vertex: blocks first, then all
+// unblocks together. The unblocks are merged with one union-find pass over
+// the new vertices and the islands they touch, so every vertex is relabelled
+// at most once per batch however many unblocks join the same islands.
+class QuarantineReachability
+{
+public:
+    static constexpr uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+
+    // blocked: one flag per vertex, empty if nothing is blocked.
+    explicit QuarantineReachability(const CsrGraph& graph, const std::vector<uint8_t>& blocked = {});
+
+    void applyBatch(const std::vector<BlockEvent>& events);
+    void block(uint32_t v);
+    void unblock(uint32_t v)
+    {
+        if (!isBlocked(v))
+            return;
+        unblockAll({v});
+    }
+
+    bool isBlocked(uint32_t v) const { return label[v] == NO_LABEL; }
+    bool reachable(uint32_t u, uint32_t v) const { return label[u] != NO_LABEL && label[u] == label[v]; }
+    uint32_t componentSize(uint32_t v) const
+    {
+        return isBlocked(v) ? 0 : static_cast<uint32_t>(members[label[v]].size());
+    }
+    uint32_t safeIslandCount() const { return components; }
+
+    // Fewest hops from s to e through unblocked servers, -1 if none (task 9,
+    // part 2). Returns at once when the labels differ.
+    int64_t shortestPath(uint32_t s, uint32_t e);
+
+    // Vertices visited by block searches, unblock merges and path queries.
+    uint64_t traversedVertices() const { return traversed; }
+
+    // Offline variant for a stream of blocks only: the island count after
+    // each block. Processed backwards, every block becomes an unblock, so one
+    // union-find answers the whole stream.
+    static std::vector<uint32_t> islandsAfterEachBlock(const CsrGraph& graph, std::vector<uint8_t> blocked,
+                                                       const std::vector<uint32_t>& sequence);
+
+private:
+    const CsrGraph& graph;
+    std::vector<uint32_t> label;                 // NO_LABEL for blocked vertices
+    std::vector<uint32_t> position;              // index inside members[label]
+    std::vector<std::vector<uint32_t>> members;  // vertices per label
+    std::vector<uint32_t> free_labels;
+    uint32_t components = 0;
+    uint64_t traversed = 0;
+
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> owner;
+    uint32_t epoch = 0;
+
+    uint32_t nextEpoch();
+    uint32_t newLabel();
+    void addMember(uint32_t l, uint32_t v);
+    void removeMember(uint32_t v);
+    void moveAll(uint32_t from, uint32_t to);
+    void splitAround(const std::vector<uint32_t>& starts, uint32_t old_label);
+    void unblockAll(const std::vector<uint32_t>& vertices);
+};
+
+inline QuarantineReachability::QuarantineReachability(const CsrGraph& graph, const std::vector<uint8_t>& blocked)
+    : graph(graph),
+      label(graph.vertex_count, NO_LABEL),
+      position(graph.vertex_count, 0),
+      members(graph.vertex_count),
+      stamp(graph.vertex_count, 0),
+      owner(graph.vertex_count, 0)
+{
+    for (uint32_t l = graph.vertex_count; l-- > 0;)
+        free_labels.push_back(l);
+
+    for (uint32_t root = 0; root < graph.vertex_count; ++root)
+    {
+        if (label[root] != NO_LABEL || (!blocked.empty() && blocked[root]))
+            continue;
+        uint32_t l = newLabel();
+        addMember(l, root);
+        for (size_t head = 0; head < members[l].size(); ++head)
+        {
+            uint32_t current = members[l][head];
+            for (const uint32_t* it = graph.neighborsBegin(current); it != graph.neighborsEnd(current); ++it)
+            {
+                if (label[*it] == NO_LABEL && (blocked.empty() || !blocked[*it]))
+                    addMember(l, *it);
+            }
+        }
+    }
+}
+
+inline uint32_t QuarantineReachability::nextEpoch()
+{
+    if (++epoch == 0)
+    {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    return epoch;
+}
+
+inline uint32_t QuarantineReachability::newLabel()
+{
+    uint32_t l = free_labels.back();
+    free_labels.pop_back();
+    components++;
+    return l;
+}
+
+inline void QuarantineReachability::addMember(uint32_t l, uint32_t v)
+{
+    label[v] = l;
+    position[v] = static_cast<uint32_t>(members[l].size());
+    members[l].push_back(v);
+}
+
+inline void QuarantineReachability::removeMember(uint32_t v)
+{
+    std::vector<uint32_t>& list = members[label[v]];
+    uint32_t last = list.back();
+    list[position[v]] = last;
+    position[last] = position[v];
+    list.pop_back();
+    label[v] = NO_LABEL;
+}
+
+inline void QuarantineReachability::moveAll(uint32_t from, uint32_t to)
+{
+    for (uint32_t w : members[from])
+    {
+        label[w] = to;
+        position[w] = static_cast<uint32_t>(members[to].size());
+        members[to].push_back(w);
+    }
+    members[from].clear();
+    members[from].shrink_to_fit();
+    free_labels.push_back(from);
+    components--;
+}
+
+inline void QuarantineReachability::applyBatch(const std::vector<BlockEvent>& events)
+{
+    std::unordered_map<uint32_t, bool> final_state;
+    for (const BlockEvent& event : events)
+        final_state[event.vertex] = event.block;
+
+    std::vector<uint32_t> unblocked;
+    for (const auto& [v, blocked] : final_state)
+    {
+        if (blocked)
+            block(v);
+        else if (isBlocked(v))
+            unblocked.push_back(v);
+    }
+    unblockAll(unblocked);
+}
+
+inline void QuarantineReachability::block(uint32_t v)
+{
+    if (isBlocked(v))
+        return;
+    uint32_t l = label[v];
+    removeMember(v);
+    if (members[l].empty())
+    {
+        free_labels.push_back(l);
+        components--;
+        return;
+    }
+
+    uint32_t e = nextEpoch();
+    std::vector<uint32_t> starts;
+    for (const uint32_t* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it)
+    {
+        if (label[*it] == l && stamp[*it] != e)
+        {
+            stamp[*it] = e;
+            starts.push_back(*it);
+        }
+    }
+    if (starts.size() > 1)
+        splitAround(starts, l);
+}
+
+inline void QuarantineReachability::splitAround(const std::vector<uint32_t>& starts, uint32_t old_label)
+{
+    const uint32_t k = static_cast<uint32_t>(starts.size());
+    const uint32_t e = nextEpoch();
+    std::vector<std::vector<uint32_t>> seen(k);
+    std::vector<size_t> head(k, 0);
+    DisjointSet groups(k);
+    for (uint32_t i = 0; i < k; ++i)
+    {
+        seen[i].push_back(starts[i]);
+        stamp[starts[i]] = e;
+        owner[starts[i]] = i;
+    }
+
+    std::vector<uint8_t> running(k);
+    for (;;)
+    {
+        // Groups with at least one search that still has vertices queued.
+        std::fill(running.begin(), running.end(), 0);
+        uint32_t running_groups = 0;
+        for (uint32_t i = 0; i < k; ++i)
+        {
+            uint32_t g = groups.find(i);
+            if (head[i] < seen[i].size() && !running[g])
+            {
+                running[g] = 1;
+                running_groups++;
+            }
+        }
+        if (running_groups <= 1)
+            break;
+
+        for (uint32_t i = 0; i < k; ++i)
+        {
+            if (head[i] == seen[i].size())
+                continue;
+            uint32_t current = seen[i][head[i]++];
+            for (const uint32_t* it = graph.neighborsBegin(current); it != graph.neighborsEnd(current); ++it)
+            {
+                if (label[*it] != old_label)
+                    continue;
+                if (stamp[*it] != e)
+                {
+                    stamp[*it] = e;
+                    owner[*it] = i;
+                    seen[i].push_back(*it);
+                }
+                else
+                {
+                    groups.unite(i, owner[*it]);
+                }
+            }
+        }
+    }
+
+    // Vertices found per group; the running group (or else the largest
+    // finished one) keeps the old label.
+    std::vector<uint64_t> found(k, 0);
+    uint32_t keeper = k;
+    for (uint32_t i = 0; i < k; ++i)
+    {
+        uint32_t g = groups.find(i);
+        found[g] += seen[i].size();
+        traversed += seen[i].size();
+        if (running[g])
+            keeper = g;
+    }
+    if (keeper == k)
+    {
+        keeper = groups.find(0);
+        for (uint32_t i = 0; i < k; ++i)
+        {
+            if (found[i] > found[keeper])
+                keeper = i;
+        }
+    }
+
+    std::vector<uint32_t> piece_label(k, NO_LABEL);
+    for (uint32_t i = 0; i < k; ++i)
+    {
+        uint32_t g = groups.find(i);
+        if (g == keeper)
+            continue;
+        if (piece_label[g] == NO_LABEL)
+            piece_label[g] = newLabel();
+        for (uint32_t w : seen[i])
+        {
+            removeMember(w);
+            addMember(piece_label[g], w);
+        }
+    }
+}
+
+inline void QuarantineReachability::unblockAll(const std::vector<uint32_t>& vertices)
+{
+    if (vertices.empty())
+        return;
+
+    // Union-find nodes: the new vertices first, then every island they touch.
+    const uint32_t e = nextEpoch();
+    const uint32_t count = static_cast<uint32_t>(vertices.size());
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        stamp[vertices[i]] = e;
+        owner[vertices[i]] = i;
+    }
+
+    std::unordered_map<uint32_t, uint32_t> island_node;
+    std::vector<uint32_t> islands;
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t v = vertices[i];
+        for (const uint32_t* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it)
+        {
+            if (stamp[*it] == e)
+            {
+                links.push_back({i, owner[*it]});
+            }
+            else if (label[*it] != NO_LABEL)
+            {
+                auto [entry, added] = island_node.try_emplace(label[*it], count + islands.size());
+                if (added)
+                    islands.push_back(label[*it]);
+                links.push_back({i, entry->second});
+            }
+        }
+    }
+    traversed += count;
+
+    DisjointSet groups(count + static_cast<uint32_t>(islands.size()));
+    for (const auto& [a, b] : links)
+        groups.unite(a, b);
+
+    // The largest island of every group keeps its label, the others move in.
+    std::vector<uint32_t> keeper(count + islands.size(), NO_LABEL);
+    for (uint32_t j = 0; j < islands.size(); ++j)
+    {
+        uint32_t& best = keeper[groups.find(count + j)];
+        if (best == NO_LABEL || members[islands[j]].size() > members[best].size())
+            best = islands[j];
+    }
+    for (uint32_t j = 0; j < islands.size(); ++j)
+    {
+        uint32_t target = keeper[groups.find(count + j)];
+        if (islands[j] != target)
+        {
+            traversed += members[islands[j]].size();
+            moveAll(islands[j], target);
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t& target = keeper[groups.find(i)];
+        if (target == NO_LABEL)
+            target = newLabel();
+        addMember(target, vertices[i]);
+    }
+}
+
+inline int64_t QuarantineReachability::shortestPath(uint32_t s, uint32_t e)
+{
+    if (!reachable(s, e))
+        return -1;
+
+    const uint32_t mark = nextEpoch();
+    std::vector<uint32_t> frontier = {s}, next;
+    stamp[s] = mark;
+    for (int64_t distance = 0; !frontier.empty(); ++distance)
+    {
+        next.clear();
+        for (uint32_t current : frontier)
+        {
+            if (current == e)
+                return distance;
+            traversed++;
+            for (const uint32_t* it = graph.neighborsBegin(current); it != graph.neighborsEnd(current); ++it)
+            {
+                if (label[*it] != NO_LABEL && stamp[*it] != mark)
+                {
+                    stamp[*it] = mark;
+                    next.push_back(*it);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return -1;
+}
+
+inline std::vector<uint32_t> QuarantineReachability::islandsAfterEachBlock(const CsrGraph& graph,
+                                                                           std::vector<uint8_t> blocked,
+                                                                           const std::vector<uint32_t>& sequence)
+{
+    blocked.resize(graph.vertex_count, 0);
+
+    // Only the first block of a vertex that starts unblocked changes
+    // anything; backwards it is where the vertex comes back.
+    std::vector<uint8_t> comes_back(sequence.size(), 0);
+    for (size_t i = 0; i < sequence.size(); ++i)
+    {
+        if (!blocked[sequence[i]])
+        {
+            blocked[sequence[i]] = 1;
+            comes_back[i] = 1;
+        }
+    }
+
+    DisjointSet sets(graph.vertex_count);
+    uint32_t islands = 0;
+    auto activate = [&](uint32_t v) {
+        islands++;
+        for (const uint32_t* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it)
+        {
+            if (!blocked[*it] && sets.unite(v, *it))
+                islands--;
+        }
+    };
+    // Final state first: every edge between two safe vertices, once.
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        if (blocked[v])
+            continue;
+        islands++;
+        for (const uint32_t* it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it)
+        {
+            if (*it < v && !blocked[*it] && sets.unite(v, *it))
+                islands--;
+        }
+    }
+
+    std::vector<uint32_t> result(sequence.size());
+    for (size_t i = sequence.size(); i-- > 0;)
+    {
+        result[i] = islands;
+        if (comes_back[i])
+        {
+            blocked[sequence[i]] = 0;
+            activate(sequence[i]);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,116 @@
+// g++ -O2 -std=c++17 -mavx2 bit_matrix_graph.cpp -o bit_matrix_graph
+//
+//   ./bit_matrix_graph [vertices] [edge probability]
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "BitMatrixGraph.hpp"
+using namespace std;
+
+template <typename Func>
+double timeIt(Func&& func)
+{
+    auto start = chrono::steady_clock::now();
+    func();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+uint64_t countTrianglesHashed(unordered_map<int, unordered_set<int>>& graph)
+{
+    uint64_t total = 0;
+    for (auto& [u, neighbors] : graph)
+    {
+        for (int v : neighbors)
+        {
+            if (v <= u)
+                continue;
+            for (int w : graph[v])
+            {
+                if (w > v && neighbors.count(w))
+                    total++;
+            }
+        }
+    }
+    return total;
+}
+
+// All-pairs reachability with the bfs.cpp representation: one BFS per source.
+uint64_t countReachablePairsHashed(int n, unordered_map<int, unordered_set<int>>& graph)
+{
+    uint64_t total = 0;
+    for (int source = 0; source < n; ++source)
+    {
+        queue<int> q;
+        unordered_set<int> visited;
+        q.push(source);
+        visited.insert(source);
+        while (!q.empty())
+        {
+            int current = q.front();
+            q.pop();
+            for (int neighbor : graph[current])
+            {
+                if (!visited.count(neighbor))
+                {
+                    visited.insert(neighbor);
+                    q.push(neighbor);
+                }
+            }
+        }
+        total += visited.size();
+    }
+    return total;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 2000;
+    double p = argc > 2 ? stod(argv[2]) : 0.05;
+
+    mt19937 rng(7);
+    bernoulli_distribution coin(p);
+    BitMatrixGraph matrix(n);
+    unordered_map<int, unordered_set<int>> hashed;
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        hashed[u];
+        for (uint32_t v = u + 1; v < n; ++v)
+        {
+            if (coin(rng))
+            {
+                matrix.addUndirectedEdge(u, v);
+                hashed[u].insert(v);
+                hashed[v].insert(u);
+            }
+        }
+    }
+    cout << n << " vertices, p = " << p << ", " << matrix.wordsPerRow() * 8 << " bytes per row\n";
+
+    uint64_t triangles_matrix = 0, triangles_hashed = 0;
+    double t_matrix = timeIt([&]() { triangles_matrix = matrix.countTriangles(); });
+    double t_hashed = timeIt([&]() { triangles_hashed = countTrianglesHashed(hashed); });
+    cout << "triangles: " << triangles_matrix << " (bit matrix " << t_matrix << " s), "
+         << triangles_hashed << " (hash sets " << t_hashed << " s)\n";
+
+    uint64_t pairs_matrix = 0, pairs_hashed = 0;
+    t_matrix = timeIt([&]() {
+        BitMatrixGraph reach = matrix.transitiveClosure();
+        for (uint32_t v = 0; v < n; ++v)
+            pairs_matrix += reach.outDegree(v);
+    });
+    t_hashed = timeIt([&]() { pairs_hashed = countReachablePairsHashed(n, hashed); });
+    cout << "reachable pairs: " << pairs_matrix << " (bit matrix " << t_matrix << " s), "
+         << pairs_hashed << " (hash sets " << t_hashed << " s)\n";
+
+    vector<int> distance = matrix.bfs(0);
+    int farthest = 0;
+    for (int d : distance)
+        farthest = max(farthest, d);
+    cout << "bit-parallel BFS from 0: eccentricity " << farthest << "\n";
+    return 0;
+}
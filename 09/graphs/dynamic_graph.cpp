@@ -0,0 +1,120 @@
+// g++ -O2 -std=c++17 dynamic_graph.cpp -o dynamic_graph
+//
+//   ./dynamic_graph [vertices] [operations] [batch size]
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DynamicGraph.hpp"
+using namespace std;
+
+// Task 4 answered the old way: a fresh BFS per query.
+bool pathExists(const DynamicGraph& graph, uint32_t a, uint32_t b)
+{
+    vector<bool> visited(graph.vertexCount(), false);
+    queue<uint32_t> q;
+    q.push(a);
+    visited[a] = true;
+    while (!q.empty())
+    {
+        uint32_t current = q.front();
+        q.pop();
+        if (current == b)
+            return true;
+        for (uint32_t neighbor : graph.neighbors(current))
+        {
+            if (!visited[neighbor])
+            {
+                visited[neighbor] = true;
+                q.push(neighbor);
+            }
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    uint64_t operations = argc > 2 ? stoull(argv[2]) : 10000000;
+    uint32_t batch_size = argc > 3 ? stoul(argv[3]) : 1000;
+
+    // 45% inserts, 5% deletes of a previously inserted edge, 50% queries.
+    mt19937_64 rng(11);
+    uniform_int_distribution<uint32_t> vertex(0, n - 1);
+    uniform_int_distribution<int> kind(0, 99);
+
+    DynamicGraph graph(n);
+    vector<pair<uint32_t, uint32_t>> live;
+    vector<EdgeUpdate> batch;
+    uint64_t queries = 0, connected = 0, updates = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint64_t op = 0; op < operations; ++op)
+    {
+        int k = kind(rng);
+        if (k < 45)
+        {
+            uint32_t u = vertex(rng), v = vertex(rng);
+            batch.push_back({u, v, true});
+            live.push_back({u, v});
+        }
+        else if (k < 50 && !live.empty())
+        {
+            size_t i = rng() % live.size();
+            batch.push_back({live[i].first, live[i].second, false});
+            live[i] = live.back();
+            live.pop_back();
+        }
+        else
+        {
+            if (!batch.empty())
+            {
+                updates += batch.size();
+                graph.applyBatch(batch);
+                batch.clear();
+            }
+            uint32_t a = vertex(rng), b = vertex(rng);
+            bool answer = graph.connected(a, b);
+            connected += answer;
+            queries++;
+        }
+
+        if (batch.size() >= batch_size)
+        {
+            updates += batch.size();
+            graph.applyBatch(batch);
+            batch.clear();
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!batch.empty())
+        graph.applyBatch(batch);
+
+    cout << operations << " operations (" << updates << " updates, " << queries << " queries) in "
+         << seconds << " s = " << operations / seconds / 1e6 << " M ops/s\n";
+    cout << "components: " << graph.componentCount() << ", connected answers: " << connected
+         << ", vertices searched by deletes: " << graph.searchedVertices()
+         << ", certificate edges: " << graph.certificateSize() << "\n";
+
+    // Compare with a fresh BFS per query on the final graph.
+    const int checked_queries = 1000;
+    int mismatches = 0;
+    double label_seconds = 0, bfs_seconds = 0;
+    for (int i = 0; i < checked_queries; ++i)
+    {
+        uint32_t a = vertex(rng), b = vertex(rng);
+        auto t0 = chrono::steady_clock::now();
+        bool answer = graph.connected(a, b);
+        auto t1 = chrono::steady_clock::now();
+        mismatches += pathExists(graph, a, b) != answer;
+        auto t2 = chrono::steady_clock::now();
+        label_seconds += chrono::duration<double>(t1 - t0).count();
+        bfs_seconds += chrono::duration<double>(t2 - t1).count();
+    }
+    cout << "per query on the final graph: " << label_seconds / checked_queries * 1e9 << " ns (labels) vs "
+         << bfs_seconds / checked_queries * 1e6 << " us (fresh BFS), " << mismatches << " mismatches\n";
+    return 0;
+}
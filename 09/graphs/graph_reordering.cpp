@@ -0,0 +1,201 @@
+// g++ -O2 -std=c++17 graph_reordering.cpp -o graph_reordering
+//
+//   ./graph_reordering [scale] [edge factor]
+//
+// R-MAT graph with 2^scale vertices and randomly shuffled IDs (the arbitrary
+// numbering of a crawled web graph). Cache misses come from perf_event_open
+// and print as n/a where the kernel does not allow it.
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "CsrGraph.hpp"
+#include "GraphReordering.hpp"
+using namespace std;
+
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMissCounter()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    void start()
+    {
+        if (fd < 0)
+            return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    string stop()
+    {
+        if (fd < 0)
+            return "n/a";
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count))
+            return "n/a";
+        return to_string(count);
+    }
+
+private:
+    int fd = -1;
+};
+
+vector<int> bfsDistances(const CsrGraph& graph, uint32_t source)
+{
+    vector<int> distance(graph.vertex_count, -1);
+    vector<uint32_t> q;
+    q.reserve(graph.vertex_count);
+    q.push_back(source);
+    distance[source] = 0;
+    for (size_t head = 0; head < q.size(); ++head)
+    {
+        uint32_t current = q[head];
+        for (const uint32_t* n = graph.neighborsBegin(current); n != graph.neighborsEnd(current); ++n)
+        {
+            if (distance[*n] < 0)
+            {
+                distance[*n] = distance[current] + 1;
+                q.push_back(*n);
+            }
+        }
+    }
+    return distance;
+}
+
+// Label propagation by repeated BFS, like task 6 of 09/graphs.
+vector<uint32_t> connectedComponents(const CsrGraph& graph)
+{
+    const uint32_t none = UINT32_MAX;
+    vector<uint32_t> component(graph.vertex_count, none);
+    vector<uint32_t> q;
+    q.reserve(graph.vertex_count);
+    uint32_t next_label = 0;
+    for (uint32_t start = 0; start < graph.vertex_count; ++start)
+    {
+        if (component[start] != none)
+            continue;
+        q.assign(1, start);
+        component[start] = next_label;
+        for (size_t head = 0; head < q.size(); ++head)
+        {
+            uint32_t current = q[head];
+            for (const uint32_t* n = graph.neighborsBegin(current); n != graph.neighborsEnd(current); ++n)
+            {
+                if (component[*n] == none)
+                {
+                    component[*n] = next_label;
+                    q.push_back(*n);
+                }
+            }
+        }
+        next_label++;
+    }
+    return component;
+}
+
+CsrGraph makeRmat(int scale, int edge_factor)
+{
+    uint32_t n = 1u << scale;
+    mt19937_64 rng(5);
+    uniform_real_distribution<double> coin(0, 1);
+
+    vector<pair<uint32_t, uint32_t>> edges(uint64_t(n) * edge_factor);
+    for (auto& edge : edges)
+    {
+        uint32_t u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit)
+        {
+            double r = coin(rng);
+            int quadrant = r < 0.57 ? 0 : r < 0.76 ? 1 : r < 0.95 ? 2 : 3;
+            u = (u << 1) | (quadrant >> 1);
+            v = (v << 1) | (quadrant & 1);
+        }
+        edge = {u, v};
+    }
+
+    vector<uint32_t> shuffle(n);
+    iota(shuffle.begin(), shuffle.end(), 0u);
+    std::shuffle(shuffle.begin(), shuffle.end(), rng);
+    for (auto& edge : edges)
+        edge = {shuffle[edge.first], shuffle[edge.second]};
+    return CsrGraph::fromEdges(n, edges);
+}
+
+void measure(const string& name, const CsrGraph& graph, const vector<uint32_t>& new_id,
+             uint32_t source, const vector<int>& expected_distance)
+{
+    CacheMissCounter counter;
+    auto start = chrono::steady_clock::now();
+    counter.start();
+    vector<int> distance = bfsDistances(graph, new_id[source]);
+    string bfs_misses = counter.stop();
+    double bfs_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    counter.start();
+    vector<uint32_t> component = connectedComponents(graph);
+    string cc_misses = counter.stop();
+    double cc_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    bool same = mapBack(distance, new_id) == expected_distance;
+    cout << name << ": span " << averageEdgeSpan(graph) << ", BFS " << bfs_seconds * 1e3 << " ms ("
+         << bfs_misses << " misses), CC " << cc_seconds * 1e3 << " ms (" << cc_misses << " misses)"
+         << (same ? "" : " MISMATCH") << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    int scale = argc > 1 ? stoi(argv[1]) : 20;
+    int edge_factor = argc > 2 ? stoi(argv[2]) : 8;
+
+    CsrGraph graph = makeRmat(scale, edge_factor);
+    cout << graph.vertex_count << " vertices, " << graph.edgeCount() << " arcs\n";
+
+    uint32_t source = graph.adjacency.empty() ? 0 : graph.adjacency[0];
+    vector<uint32_t> identity(graph.vertex_count);
+    iota(identity.begin(), identity.end(), 0u);
+    vector<int> expected = bfsDistances(graph, source);
+    measure("original", graph, identity, source, expected);
+
+    struct Ordering
+    {
+        string name;
+        vector<uint32_t> (*compute)(const CsrGraph&);
+    };
+    for (const Ordering& ordering : {Ordering{"degree", degreeOrder}, Ordering{"bfs", bfsOrder},
+                                     Ordering{"rcm", reverseCuthillMcKee}})
+    {
+        auto start = chrono::steady_clock::now();
+        vector<uint32_t> new_id = ordering.compute(graph);
+        CsrGraph reordered = relabel(graph, new_id);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "  (" << ordering.name << " reordering took " << seconds * 1e3 << " ms)\n";
+        measure(ordering.name, reordered, new_id, source, expected);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// g++ -O2 -std=c++17 -march=native ms_bfs.cpp -o ms_bfs
+//
+//   ./ms_bfs [vertices] [average degree] [sources]
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CsrGraph.hpp"
+#include "MultiSourceBfs.hpp"
+using namespace std;
+
+// One traversal per source with a fresh queue and visited array, the way
+// bfs.cpp does it (but on the CSR so only the batching differs).
+vector<uint64_t> repeatedBfs(const CsrGraph& graph, const vector<uint32_t>& sources)
+{
+    vector<uint64_t> sums;
+    for (uint32_t source : sources)
+    {
+        vector<int> distance(graph.vertex_count, -1);
+        vector<uint32_t> q;
+        q.push_back(source);
+        distance[source] = 0;
+
+        uint64_t sum = 0;
+        for (size_t head = 0; head < q.size(); ++head)
+        {
+            uint32_t current = q[head];
+            sum += distance[current];
+            for (const uint32_t* n = graph.neighborsBegin(current); n != graph.neighborsEnd(current); ++n)
+            {
+                if (distance[*n] < 0)
+                {
+                    distance[*n] = distance[current] + 1;
+                    q.push_back(*n);
+                }
+            }
+        }
+        sums.push_back(sum);
+    }
+    return sums;
+}
+
+template <typename Func>
+double timeIt(Func&& func)
+{
+    auto start = chrono::steady_clock::now();
+    func();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 100000;
+    uint32_t degree = argc > 2 ? stoul(argv[2]) : 8;
+    uint32_t source_count = argc > 3 ? stoul(argv[3]) : 10000;
+
+    mt19937 rng(3);
+    uniform_int_distribution<uint32_t> vertex(0, n - 1);
+    vector<pair<uint32_t, uint32_t>> edges(uint64_t(n) * degree / 2);
+    for (auto& edge : edges)
+        edge = {vertex(rng), vertex(rng)};
+    CsrGraph graph = CsrGraph::fromEdges(n, edges);
+
+    vector<uint32_t> sources(source_count);
+    for (auto& s : sources)
+        s = vertex(rng);
+
+    vector<uint64_t> expected, sums64, sums256;
+    double t_single = timeIt([&]() { expected = repeatedBfs(graph, sources); });
+
+    MultiSourceBfs<1> bfs64(graph);
+    double t_64 = timeIt([&]() { sums64 = bfs64.distanceSums(sources); });
+
+    MultiSourceBfs<4> bfs256(graph);
+    double t_256 = timeIt([&]() { sums256 = bfs256.distanceSums(sources); });
+
+    cout << n << " vertices, " << graph.edgeCount() << " arcs, " << source_count << " sources\n";
+    cout << "repeated BFS: " << t_single << " s\n";
+    cout << "MS-BFS x64:   " << t_64 << " s" << (sums64 == expected ? "" : " MISMATCH") << "\n";
+    cout << "MS-BFS x256:  " << t_256 << " s" << (sums256 == expected ? "" : " MISMATCH") << "\n";
+    return 0;
+}
@@ -0,0 +1,184 @@
+// g++ -O2 -std=c++17 quarantine.cpp -o quarantine
+//
+//   ./quarantine [servers] [events] [batch size]
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "QuarantineReachability.hpp"
+using namespace std;
+
+// Data-centre-like topology: racks of 50 servers under a top-of-rack switch,
+// peer links inside each rack and inside each pod of 20 racks, every rack
+// switch uplinked to two of the aggregation switches, which all connect to
+// a few core switches. Vertex ids: servers, then rack, aggregation and core
+// switches.
+CsrGraph makeNetwork(uint32_t servers, uint32_t& switch_begin)
+{
+    const uint32_t rack = 50, pod = rack * 20, aggregation = 500, core = 20;
+    uint32_t racks = (servers + rack - 1) / rack;
+    switch_begin = servers;
+    uint32_t aggregation_begin = servers + racks, core_begin = aggregation_begin + aggregation;
+    uint32_t n = core_begin + core;
+
+    mt19937_64 rng(47);
+    vector<pair<uint32_t, uint32_t>> edges;
+    edges.reserve(uint64_t(servers) * 10);
+    for (uint32_t s = 0; s < servers; ++s)
+    {
+        uint32_t rack_first = s / rack * rack, rack_size = min(rack, servers - rack_first);
+        uint32_t pod_first = s / pod * pod, pod_size = min(pod, servers - pod_first);
+        edges.push_back({s, switch_begin + s / rack});
+        for (int k = 0; k < 4; ++k)
+            edges.push_back({s, rack_first + static_cast<uint32_t>(rng() % rack_size)});
+        for (int k = 0; k < 5; ++k)
+            edges.push_back({s, pod_first + static_cast<uint32_t>(rng() % pod_size)});
+    }
+    for (uint32_t r = 0; r < racks; ++r)
+    {
+        edges.push_back({switch_begin + r, aggregation_begin + static_cast<uint32_t>(rng() % aggregation)});
+        edges.push_back({switch_begin + r, aggregation_begin + static_cast<uint32_t>(rng() % aggregation)});
+    }
+    for (uint32_t a = 0; a < aggregation; ++a)
+    {
+        for (uint32_t c = 0; c < core; ++c)
+            edges.push_back({aggregation_begin + a, core_begin + c});
+    }
+    return CsrGraph::fromEdges(n, edges);
+}
+
+// What the monitoring loop did before: label everything from scratch.
+vector<uint32_t> recomputeLabels(const CsrGraph& graph, const vector<uint8_t>& blocked, uint32_t& islands)
+{
+    const uint32_t NONE = QuarantineReachability::NO_LABEL;
+    vector<uint32_t> label(graph.vertex_count, NONE);
+    vector<uint32_t> queue;
+    islands = 0;
+    for (uint32_t root = 0; root < graph.vertex_count; ++root)
+    {
+        if (blocked[root] || label[root] != NONE)
+            continue;
+        queue.assign(1, root);
+        label[root] = islands;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            for (const uint32_t* it = graph.neighborsBegin(queue[head]); it != graph.neighborsEnd(queue[head]); ++it)
+            {
+                if (!blocked[*it] && label[*it] == NONE)
+                {
+                    label[*it] = islands;
+                    queue.push_back(*it);
+                }
+            }
+        }
+        islands++;
+    }
+    return label;
+}
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    // First example of task 9 (1-based servers shifted to 0-based).
+    CsrGraph example = CsrGraph::fromEdges(6, {{0, 1}, {1, 2}, {3, 4}, {4, 5}});
+    QuarantineReachability example_network(example, {0, 0, 1, 0, 0, 0});
+    cout << "Task 9: islands " << example_network.safeIslandCount() << ", path "
+         << example_network.shortestPath(0, 1) << "\n";
+    // Unblocking a safe server changes nothing.
+    CsrGraph path = CsrGraph::fromEdges(3, {{0, 1}, {1, 2}});
+    QuarantineReachability path_network(path);
+    path_network.unblock(1);
+    bool same = path_network.componentSize(0) == 3;
+    path_network.block(1);
+    same = same && path_network.componentSize(0) == 1 && path_network.safeIslandCount() == 2;
+    cout << "unblock of a safe server" << (same ? "" : " MISMATCH") << "\n\n";
+
+    uint32_t servers = argc > 1 ? stoul(argv[1]) : 1000000;
+    uint64_t events = argc > 2 ? stoull(argv[2]) : 1000000;
+    uint32_t batch_size = argc > 3 ? stoul(argv[3]) : 1000;
+
+    uint32_t switch_begin;
+    CsrGraph network = makeNetwork(servers, switch_begin);
+    cout << network.vertex_count << " vertices, " << network.edgeCount() / 2 << " links\n";
+
+    // Incidents hit a pool of 50k servers plus, now and then, a switch.
+    mt19937_64 rng(53);
+    vector<uint32_t> suspects(50000);
+    for (uint32_t& v : suspects)
+        v = rng() % servers;
+
+    QuarantineReachability reachability(network);
+    vector<uint8_t> blocked(network.vertex_count, 0);
+    vector<BlockEvent> batch;
+    uint64_t queries = 0, reachable = 0, mismatches = 0, checks = 0;
+    double update_seconds = 0;
+    for (uint64_t event = 0; event < events; ++event)
+    {
+        uint32_t v = rng() % 100 == 0 ? switch_begin + static_cast<uint32_t>(rng() % (network.vertex_count - switch_begin))
+                                      : suspects[rng() % suspects.size()];
+        blocked[v] ^= 1;
+        batch.push_back({v, blocked[v] != 0});
+        if (batch.size() < batch_size && event + 1 < events)
+            continue;
+
+        auto start = chrono::steady_clock::now();
+        reachability.applyBatch(batch);
+        update_seconds += secondsSince(start);
+        batch.clear();
+
+        for (int q = 0; q < 100; ++q, ++queries)
+            reachable += reachability.reachable(rng() % network.vertex_count, rng() % network.vertex_count);
+
+        // Every 100 batches: compare against labelling from scratch.
+        if (event / batch_size % 100 == 0)
+        {
+            uint32_t islands;
+            vector<uint32_t> expected = recomputeLabels(network, blocked, islands);
+            checks++;
+            mismatches += islands != reachability.safeIslandCount();
+            for (int q = 0; q < 1000; ++q)
+            {
+                uint32_t a = rng() % network.vertex_count, b = rng() % network.vertex_count;
+                bool answer = !blocked[a] && expected[a] == expected[b];
+                mismatches += answer != reachability.reachable(a, b);
+            }
+        }
+    }
+
+    uint32_t islands;
+    auto start = chrono::steady_clock::now();
+    recomputeLabels(network, blocked, islands);
+    double recompute_seconds = secondsSince(start);
+    uint64_t batches = (events + batch_size - 1) / batch_size;
+    cout << events << " events in " << batches << " batches: " << update_seconds << " s ("
+         << update_seconds / events * 1e6 << " us/event), " << reachability.traversedVertices()
+         << " vertices traversed; full relabel per batch would take ~" << recompute_seconds * batches << " s\n";
+    cout << reachability.safeIslandCount() << " safe islands, " << reachable << "/" << queries
+         << " reachable pairs, " << mismatches << " mismatches in " << checks << " checks\n";
+
+    // A burst of blocks only, answered offline by reverse-time union-find.
+    vector<uint32_t> burst(100000);
+    for (uint32_t& v : burst)
+        v = rng() % network.vertex_count;
+    start = chrono::steady_clock::now();
+    vector<uint32_t> offline = QuarantineReachability::islandsAfterEachBlock(network, blocked, burst);
+    double offline_seconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    uint64_t online_mismatches = 0;
+    for (size_t i = 0; i < burst.size(); ++i)
+    {
+        reachability.block(burst[i]);
+        online_mismatches += reachability.safeIslandCount() != offline[i];
+    }
+    double online_seconds = secondsSince(start);
+    cout << burst.size() << " blocks: offline " << offline_seconds << " s, online " << online_seconds << " s, "
+         << online_mismatches << " mismatches, " << offline.back() << " islands at the end\n";
+    return 0;
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+struct ResourceEdge
+{
+    uint32_t from;
+    uint32_t to;
+    int64_t distance; // D in task 8, minimised
+    int64_t fuel;     // F in task 8, bounded by the limit L
+};
+
+// CSR graph with two non-negative integer weights per arc.
+struct ResourceGraph
+{
+    uint32_t vertex_count = 0;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<int64_t> distances;
+    std::vector<int64_t> fuels;
+
+    static ResourceGraph fromEdges(uint32_t vertex_count, const std::vector<ResourceEdge>& edges,
+                                   bool directed = false);
+};
+
+inline ResourceGraph ResourceGraph::fromEdges(uint32_t vertex_count, const std::vector<ResourceEdge>& edges,
+                                              bool directed)
+{
+    ResourceGraph graph;
+    graph.vertex_count = vertex_count;
+    graph.offsets.assign(static_cast<size_t>(vertex_count) + 1, 0);
+    for (const ResourceEdge& edge : edges)
+    {
+        if (edge.distance < 0 || edge.fuel < 0)
+            throw std::invalid_argument("Distances and fuel costs must be non-negative");
+        graph.offsets[edge.from + 1]++;
+        if (!directed)
+            graph.offsets[edge.to + 1]++;
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        graph.offsets[v + 1] += graph.offsets[v];
+
+    uint64_t arcs = graph.offsets[vertex_count];
+    graph.targets.resize(arcs);
+    graph.distances.resize(arcs);
+    graph.fuels.resize(arcs);
+    std::vector<uint64_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    auto place = [&graph, &cursor](uint32_t from, uint32_t to, const ResourceEdge& edge) {
+        uint64_t slot = cursor[from]++;
+        graph.targets[slot] = to;
+        graph.distances[slot] = edge.distance;
+        graph.fuels[slot] = edge.fuel;
+    };
+    for (const ResourceEdge& edge : edges)
+    {
+        place(edge.from, edge.to, edge);
+        if (!directed)
+            place(edge.to, edge.from, edge);
+    }
+    return graph;
+}
+
+// Monotone bucket queue (Dial's algorithm): keys are integers, popped keys
+// never decrease and a pushed key is at most max_step above the current
+// minimum, so max_step + 1 circular buckets are enough. The ring is capped
+// at max_buckets, since one long arc would otherwise size it: keys past the
+// ring's window wait in a binary heap and move into the ring as the window
+// reaches them, and an empty ring jumps straight to the heap's minimum.
+class BucketQueue
+{
+public:
+    BucketQueue(int64_t max_step, size_t max_buckets)
+        : buckets(std::min(static_cast<size_t>(max_step) + 1, std::max<size_t>(max_buckets, 1)))
+    {
+    }
+
+    void push(int64_t key, uint32_t value)
+    {
+        if (key - current < static_cast<int64_t>(buckets.size()))
+        {
+            buckets[key % buckets.size()].push_back(value);
+            in_ring++;
+        }
+        else
+        {
+            overflow.push({key, value});
+        }
+    }
+
+    bool empty() const { return in_ring == 0 && overflow.empty(); }
+
+    // Key of the next pop; moves the cursor over empty buckets.
+    int64_t minKey()
+    {
+        while (true)
+        {
+            if (in_ring == 0)
+                current = std::max(current, overflow.top().first);
+            while (!overflow.empty() && overflow.top().first - current < static_cast<int64_t>(buckets.size()))
+            {
+                buckets[overflow.top().first % buckets.size()].push_back(overflow.top().second);
+                in_ring++;
+                overflow.pop();
+            }
+            if (!buckets[current % buckets.size()].empty())
+                return current;
+            current++;
+        }
+    }
+
+    uint32_t pop()
+    {
+        std::vector<uint32_t>& bucket = buckets[minKey() % buckets.size()];
+        uint32_t value = bucket.back();
+        bucket.pop_back();
+        in_ring--;
+        return value;
+    }
+
+private:
+    using Entry = std::pair<int64_t, uint32_t>;
+
+    std::vector<std::vector<uint32_t>> buckets;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> overflow;
+    int64_t current = 0;
+    size_t in_ring = 0;
+};
+
+struct ConstrainedPath
+{
+    enum class Status
+    {
+        Found,
+        Unreachable,      // no path within the fuel limit (task 8: -1)
+        LabelLimitReached // label pool exhausted before the target settled
+    };
+
+    Status status = Status::Unreachable;
+    int64_t distance = -1;
+    int64_t fuel = 0;
+    std::vector<uint32_t> vertices; // source .. target
+    uint64_t labels_created = 0;
+};
+
+// Resource-constrained shortest path (task 8): minimise total distance
+// subject to total fuel <= limit.
+//
+// Label setting instead of a (vertex, remaining fuel) state space: a label
+// is a partial path (vertex, distance, fuel). Two reverse Dijkstra runs from
+// the target give, for every vertex, the least distance and the least fuel
+// still needed. Labels leave the bucket queue ordered by distance + least
+// remaining distance (A*), which for one vertex is plain distance order, so
+// a label is Pareto-dominated exactly when an already settled label at the
+// same vertex used no more fuel: one "best settled fuel" value per vertex is
+// the whole dominance check. A label is also dropped when
+//   - even the least-fuel completion would exceed the limit, or
+//   - its distance lower bound exceeds the distance of the least-fuel path
+//     (a known feasible answer).
+// The first settled label at the target is optimal.
+//
+// Labels live in one pool vector (predecessor links for the path); the pool
+// is capped at max_labels entries to bound memory.
+class ConstrainedShortestPath
+{
+public:
+    explicit ConstrainedShortestPath(const ResourceGraph& graph, uint64_t max_labels = 1u << 26);
+
+    ConstrainedPath solve(uint32_t source, uint32_t target, int64_t fuel_limit);
+
+    // Fuel of the least-fuel path (-1 if target is unreachable).
+    int64_t minimumFuel(uint32_t source, uint32_t target);
+
+private:
+    struct Label
+    {
+        uint32_t vertex;
+        uint32_t parent; // index in the pool, NO_PARENT for the source
+        int64_t distance;
+        int64_t fuel;
+    };
+    static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+    static constexpr int64_t INF = std::numeric_limits<int64_t>::max();
+
+    const ResourceGraph& graph;
+    uint64_t max_labels;
+    std::vector<uint64_t> reverse_offsets;
+    std::vector<uint64_t> reverse_arcs; // arc index in graph, grouped by target
+
+    uint32_t bounds_target = NO_PARENT;
+    std::vector<int64_t> fuel_to_target;
+    std::vector<int64_t> distance_to_target;
+    std::vector<uint64_t> least_fuel_arc; // next arc on the least-fuel path
+
+    std::vector<Label> pool;
+    std::vector<int64_t> settled_fuel;
+
+    // Dijkstra towards target over reversed arcs with the given weights.
+    void reverseDijkstra(uint32_t target, const std::vector<int64_t>& weights, std::vector<int64_t>& cost,
+                         std::vector<uint64_t>* next_arc);
+    void computeBounds(uint32_t target);
+};
+
+inline ConstrainedShortestPath::ConstrainedShortestPath(const ResourceGraph& graph, uint64_t max_labels)
+    : graph(graph), max_labels(std::min<uint64_t>(max_labels, NO_PARENT))
+{
+    reverse_offsets.assign(static_cast<size_t>(graph.vertex_count) + 1, 0);
+    for (uint32_t target : graph.targets)
+        reverse_offsets[target + 1]++;
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+        reverse_offsets[v + 1] += reverse_offsets[v];
+
+    reverse_arcs.resize(graph.targets.size());
+    std::vector<uint64_t> cursor(reverse_offsets.begin(), reverse_offsets.end() - 1);
+    for (uint64_t e = 0; e < graph.targets.size(); ++e)
+        reverse_arcs[cursor[graph.targets[e]]++] = e;
+}
+
+inline void ConstrainedShortestPath::reverseDijkstra(uint32_t target, const std::vector<int64_t>& weights,
+                                                     std::vector<int64_t>& cost, std::vector<uint64_t>* next_arc)
+{
+    // Arc sources are found through upper_bound on offsets, which keeps the
+    // reverse index at one integer per arc.
+    cost.assign(graph.vertex_count, INF);
+    if (next_arc)
+        next_arc->assign(graph.vertex_count, UINT64_MAX);
+
+    using Item = std::pair<int64_t, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+    cost[target] = 0;
+    heap.push({0, target});
+    while (!heap.empty())
+    {
+        auto [c, v] = heap.top();
+        heap.pop();
+        if (c > cost[v])
+            continue;
+        for (uint64_t i = reverse_offsets[v]; i < reverse_offsets[v + 1]; ++i)
+        {
+            uint64_t e = reverse_arcs[i];
+            uint32_t u = static_cast<uint32_t>(
+                std::upper_bound(graph.offsets.begin(), graph.offsets.end(), e) - graph.offsets.begin() - 1);
+            if (c + weights[e] < cost[u])
+            {
+                cost[u] = c + weights[e];
+                if (next_arc)
+                    (*next_arc)[u] = e;
+                heap.push({cost[u], u});
+            }
+        }
+    }
+}
+
+inline void ConstrainedShortestPath::computeBounds(uint32_t target)
+{
+    if (bounds_target == target)
+        return;
+    reverseDijkstra(target, graph.fuels, fuel_to_target, &least_fuel_arc);
+    reverseDijkstra(target, graph.distances, distance_to_target, nullptr);
+    bounds_target = target;
+}
+
+inline int64_t ConstrainedShortestPath::minimumFuel(uint32_t source, uint32_t target)
+{
+    computeBounds(target);
+    return fuel_to_target[source] == INF ? -1 : fuel_to_target[source];
+}
+
+inline ConstrainedPath ConstrainedShortestPath::solve(uint32_t source, uint32_t target, int64_t fuel_limit)
+{
+    ConstrainedPath result;
+    computeBounds(target);
+    // INF first: it is not above a fuel_limit of INT64_MAX.
+    if (fuel_to_target[source] == INF || fuel_to_target[source] > fuel_limit)
+        return result;
+
+    // Distance of the least-fuel path: feasible, so an upper bound.
+    int64_t incumbent = 0;
+    for (uint32_t v = source; v != target;)
+    {
+        uint64_t e = least_fuel_arc[v];
+        incumbent += graph.distances[e];
+        v = graph.targets[e];
+    }
+
+    // A* keys grow by at most this much per arc; it sizes the bucket ring
+    // (up to the cap).
+    int64_t max_step = 0;
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        if (distance_to_target[v] == INF)
+            continue;
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+        {
+            int64_t h = distance_to_target[graph.targets[e]];
+            if (h != INF)
+                max_step = std::max(max_step, graph.distances[e] + h - distance_to_target[v]);
+        }
+    }
+
+    pool.clear();
+    settled_fuel.assign(graph.vertex_count, INF);
+    BucketQueue queue(max_step, static_cast<size_t>(graph.vertex_count) * 4 + 1024);
+
+    pool.push_back({source, NO_PARENT, 0, 0});
+    queue.push(distance_to_target[source], 0);
+
+    while (!queue.empty())
+    {
+        uint32_t index = queue.pop();
+        Label label = pool[index];
+        if (label.fuel >= settled_fuel[label.vertex])
+            continue; // dominated by a settled label with no larger distance
+        settled_fuel[label.vertex] = label.fuel;
+
+        if (label.vertex == target)
+        {
+            result.status = ConstrainedPath::Status::Found;
+            result.distance = label.distance;
+            result.fuel = label.fuel;
+            for (uint32_t i = index; i != NO_PARENT; i = pool[i].parent)
+                result.vertices.push_back(pool[i].vertex);
+            std::reverse(result.vertices.begin(), result.vertices.end());
+            break;
+        }
+
+        for (uint64_t e = graph.offsets[label.vertex]; e < graph.offsets[label.vertex + 1]; ++e)
+        {
+            uint32_t next = graph.targets[e];
+            int64_t fuel = label.fuel + graph.fuels[e];
+            int64_t distance = label.distance + graph.distances[e];
+            if (fuel >= settled_fuel[next] || fuel_to_target[next] == INF ||
+                fuel_to_target[next] > fuel_limit - fuel || distance + distance_to_target[next] > incumbent)
+                continue;
+
+            if (pool.size() >= max_labels)
+            {
+                result.status = ConstrainedPath::Status::LabelLimitReached;
+                result.labels_created = pool.size();
+                return result;
+            }
+            pool.push_back({next, index, distance, fuel});
+            queue.push(distance + distance_to_target[next], static_cast<uint32_t>(pool.size() - 1));
+        }
+    }
+
+    result.labels_created = pool.size();
+    return result;
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "WeightedGraph.hpp"
+
+// Reusable barrier for a fixed group of threads. Spins briefly and then
+// yields, so it also behaves when there are more threads than cores.
+class SpinBarrier
+{
+public:
+    explicit SpinBarrier(unsigned count) : count(count), waiting(0), generation(0) {}
+
+    void wait()
+    {
+        unsigned gen = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+        {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+        for (int spins = 0; generation.load(std::memory_order_acquire) == gen; ++spins)
+        {
+            if (spins > 64)
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    const unsigned count;
+    std::atomic<unsigned> waiting;
+    std::atomic<unsigned> generation;
+};
+
+// Topological engine for the DAG tasks of 10/graphs (4: course order,
+// 5: cycle check, 6: DAG shortest path, 9: critical path).
+//
+// The constructor runs a level-synchronous Kahn's algorithm: level 0 holds
+// the vertices without prerequisites, level k + 1 the vertices whose last
+// prerequisite is in level k. Each level is split between threads that
+// decrement atomic in-degree counters and collect newly freed vertices into
+// thread-local frontiers. If some vertices are never freed the graph has a
+// cycle and cycle() returns one as a witness.
+//
+// Path DPs then run level by level in "pull" form over the transposed
+// graph: all predecessors of a level are final before the level starts, so
+// vertices of one level are computed in parallel without atomics.
+class DagEngine
+{
+public:
+    static constexpr int64_t UNREACHABLE_MIN = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t UNREACHABLE_MAX = std::numeric_limits<int64_t>::min();
+
+    // Levels narrower than this are processed by a single thread.
+    static constexpr uint64_t PARALLEL_GRAIN = 4096;
+
+    explicit DagEngine(const WeightedCsrGraph& graph, unsigned threads = 0);
+
+    bool isAcyclic() const { return order_.size() == graph.vertex_count; }
+
+    // Vertices in topological order, grouped by level. Only the vertices
+    // outside any cycle's reach when the graph is not acyclic.
+    const std::vector<uint32_t>& order() const { return order_; }
+    size_t levelCount() const { return level_begin.size() - 1; }
+    const uint32_t* levelBegin(size_t level) const { return order_.data() + level_begin[level]; }
+    const uint32_t* levelEnd(size_t level) const { return order_.data() + level_begin[level + 1]; }
+
+    // v0 -> v1 -> ... -> vk -> v0, empty for a DAG.
+    const std::vector<uint32_t>& cycle() const { return cycle_; }
+
+    // The path DPs below throw std::logic_error unless isAcyclic().
+
+    // Task 6: shortest distance from source to every vertex
+    // (UNREACHABLE_MIN where there is no path).
+    std::vector<int64_t> shortestFrom(uint32_t source, std::vector<uint32_t>* parent = nullptr) const;
+
+    // Longest distance from source (UNREACHABLE_MAX where there is no path).
+    std::vector<int64_t> longestFrom(uint32_t source, std::vector<uint32_t>* parent = nullptr) const;
+
+    // Task 9: length of the longest path anywhere in the DAG, optionally the
+    // path itself.
+    int64_t criticalPath(std::vector<uint32_t>* path = nullptr) const;
+
+private:
+    const WeightedCsrGraph& graph;
+    WeightedCsrGraph reverse;
+    unsigned threads;
+    std::vector<uint32_t> order_;
+    std::vector<uint64_t> level_begin;
+    std::vector<uint32_t> cycle_;
+
+    void sortTopologically();
+    void findCycle();
+
+    // Calls visit(v) for every vertex of every level, levels in order,
+    // vertices of a level spread over the worker threads.
+    template <typename Visit>
+    void forEachLevel(Visit&& visit) const;
+
+    template <typename Better>
+    std::vector<int64_t> pathDp(uint32_t source, int64_t unreachable, Better better,
+                                std::vector<uint32_t>* parent) const;
+};
+
+inline DagEngine::DagEngine(const WeightedCsrGraph& graph, unsigned threads)
+    : graph(graph), reverse(graph.transposed())
+{
+    this->threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    sortTopologically();
+    if (!isAcyclic())
+        findCycle();
+}
+
+inline void DagEngine::sortTopologically()
+{
+    const uint32_t n = graph.vertex_count;
+    std::unique_ptr<std::atomic<uint32_t>[]> in_degree(new std::atomic<uint32_t>[n]);
+    order_.clear();
+    order_.reserve(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        uint32_t degree = static_cast<uint32_t>(reverse.offsets[v + 1] - reverse.offsets[v]);
+        in_degree[v].store(degree, std::memory_order_relaxed);
+        if (degree == 0)
+            order_.push_back(v);
+    }
+
+    level_begin.assign(1, 0);
+    std::vector<std::vector<uint32_t>> freed(threads);
+    SpinBarrier barrier(threads);
+
+    auto release = [&](uint64_t begin, uint64_t end, std::vector<uint32_t>& out) {
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            uint32_t v = order_[i];
+            for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+            {
+                uint32_t w = graph.targets[e];
+                if (in_degree[w].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    out.push_back(w);
+            }
+        }
+    };
+
+    // The level to process in step k is published in state[k % 2] by
+    // thread 0 during step k - 1, so it never overwrites a slot that a
+    // slower thread may still be reading.
+    struct LevelState
+    {
+        uint64_t first;
+        uint64_t size;
+    };
+    LevelState state[2] = {{0, order_.size()}, {0, 0}};
+
+    auto worker = [&](unsigned t) {
+        for (unsigned step = 0;; ++step)
+        {
+            const LevelState current = state[step & 1];
+            LevelState& next = state[(step + 1) & 1];
+            if (current.size == 0)
+                return;
+
+            if (current.size < PARALLEL_GRAIN || threads == 1)
+            {
+                // Thread 0 runs narrow levels alone until a wide one shows up.
+                if (t == 0)
+                {
+                    uint64_t first = current.first;
+                    do
+                    {
+                        uint64_t end = order_.size();
+                        level_begin.push_back(end);
+                        release(first, end, freed[0]);
+                        order_.insert(order_.end(), freed[0].begin(), freed[0].end());
+                        freed[0].clear();
+                        first = end;
+                    } while (order_.size() > first && order_.size() - first < PARALLEL_GRAIN);
+                    next = {first, order_.size() - first};
+                }
+                barrier.wait();
+                continue;
+            }
+
+            uint64_t first = current.first, size = current.size;
+            release(first + size * t / threads, first + size * (t + 1) / threads, freed[t]);
+            barrier.wait();
+
+            if (t == 0)
+            {
+                level_begin.push_back(first + size);
+                for (auto& local : freed)
+                {
+                    order_.insert(order_.end(), local.begin(), local.end());
+                    local.clear();
+                }
+                next = {first + size, order_.size() - first - size};
+            }
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+}
+
+inline void DagEngine::findCycle()
+{
+    // Every vertex left out of the order has an unprocessed predecessor, so
+    // walking predecessors among those vertices must eventually repeat one.
+    const uint32_t n = graph.vertex_count;
+    std::vector<bool> placed(n, false);
+    for (uint32_t v : order_)
+        placed[v] = true;
+
+    uint32_t current = 0;
+    while (placed[current])
+        current++;
+
+    std::vector<uint32_t> position(n, UINT32_MAX);
+    std::vector<uint32_t> walk;
+    while (position[current] == UINT32_MAX)
+    {
+        position[current] = static_cast<uint32_t>(walk.size());
+        walk.push_back(current);
+        for (uint64_t e = reverse.edgesBegin(current); e < reverse.edgesEnd(current); ++e)
+        {
+            if (!placed[reverse.targets[e]])
+            {
+                current = reverse.targets[e];
+                break;
+            }
+        }
+    }
+
+    // walk[position[current]..] follows arcs backwards; reverse it.
+    cycle_.assign(walk.begin() + position[current], walk.end());
+    std::reverse(cycle_.begin(), cycle_.end());
+}
+
+template <typename Visit>
+void DagEngine::forEachLevel(Visit&& visit) const
+{
+    if (!isAcyclic())
+        throw std::logic_error("Path DP on a graph with a cycle");
+
+    // Consecutive narrow levels are merged into one serial step for thread
+    // 0, so a long chain does not pay for a barrier per vertex.
+    struct Step
+    {
+        size_t first_level;
+        size_t last_level;
+        bool parallel;
+    };
+    std::vector<Step> steps;
+    for (size_t level = 0; level < levelCount(); ++level)
+    {
+        bool wide = threads > 1 && level_begin[level + 1] - level_begin[level] >= PARALLEL_GRAIN;
+        if (!wide && !steps.empty() && !steps.back().parallel)
+            steps.back().last_level = level;
+        else
+            steps.push_back({level, level, wide});
+    }
+
+    SpinBarrier barrier(threads);
+    auto worker = [&](unsigned t) {
+        for (const Step& step : steps)
+        {
+            if (step.parallel)
+            {
+                uint64_t first = level_begin[step.first_level];
+                uint64_t size = level_begin[step.first_level + 1] - first;
+                for (uint64_t i = first + size * t / threads; i < first + size * (t + 1) / threads; ++i)
+                    visit(order_[i]);
+            }
+            else if (t == 0)
+            {
+                for (uint64_t i = level_begin[step.first_level]; i < level_begin[step.last_level + 1]; ++i)
+                    visit(order_[i]);
+            }
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+}
+
+template <typename Better>
+std::vector<int64_t> DagEngine::pathDp(uint32_t source, int64_t unreachable, Better better,
+                                       std::vector<uint32_t>* parent) const
+{
+    std::vector<int64_t> distance(graph.vertex_count, unreachable);
+    if (parent)
+        parent->assign(graph.vertex_count, UINT32_MAX);
+    distance[source] = 0;
+
+    forEachLevel([&](uint32_t v) {
+        if (v == source)
+            return;
+        int64_t best = unreachable;
+        uint32_t best_parent = UINT32_MAX;
+        for (uint64_t e = reverse.edgesBegin(v); e < reverse.edgesEnd(v); ++e)
+        {
+            uint32_t u = reverse.targets[e];
+            if (distance[u] == unreachable)
+                continue;
+            int64_t candidate = distance[u] + reverse.weights[e];
+            if (best == unreachable || better(candidate, best))
+            {
+                best = candidate;
+                best_parent = u;
+            }
+        }
+        distance[v] = best;
+        if (parent)
+            (*parent)[v] = best_parent;
+    });
+    return distance;
+}
+
+inline std::vector<int64_t> DagEngine::shortestFrom(uint32_t source, std::vector<uint32_t>* parent) const
+{
+    return pathDp(source, UNREACHABLE_MIN, [](int64_t a, int64_t b) { return a < b; }, parent);
+}
+
+inline std::vector<int64_t> DagEngine::longestFrom(uint32_t source, std::vector<uint32_t>* parent) const
+{
+    return pathDp(source, UNREACHABLE_MAX, [](int64_t a, int64_t b) { return a > b; }, parent);
+}
+
+inline int64_t DagEngine::criticalPath(std::vector<uint32_t>* path) const
+{
+    // Longest path ending at v, starting anywhere (sources start at 0).
+    std::vector<int64_t> finish(graph.vertex_count, 0);
+    std::vector<uint32_t> parent(graph.vertex_count, UINT32_MAX);
+
+    forEachLevel([&](uint32_t v) {
+        for (uint64_t e = reverse.edgesBegin(v); e < reverse.edgesEnd(v); ++e)
+        {
+            int64_t candidate = finish[reverse.targets[e]] + reverse.weights[e];
+            if (parent[v] == UINT32_MAX || candidate > finish[v])
+            {
+                finish[v] = candidate;
+                parent[v] = reverse.targets[e];
+            }
+        }
+    });
+
+    if (order_.empty())
+        return 0;
+    uint32_t last = order_[0];
+    for (uint32_t v : order_)
+    {
+        if (finish[v] > finish[last])
+            last = v;
+    }
+
+    if (path)
+    {
+        path->clear();
+        for (uint32_t v = last; v != UINT32_MAX; v = parent[v])
+            path->push_back(v);
+        std::reverse(path->begin(), path->end());
+    }
+    return finish[last];
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "DagEngine.hpp"
+#include "WeightedGraph.hpp"
+
+struct ExecutionReport
+{
+    double seconds = 0;          // achieved makespan (wall clock)
+    uint64_t tasks = 0;
+    uint64_t steals = 0;
+    unsigned threads = 0;
+    int64_t critical_path = 0;   // longest chain of estimated costs
+    int64_t total_cost = 0;      // sum of estimated costs
+
+    // No schedule can beat the longest dependency chain or the total work
+    // spread perfectly over all threads (in estimated cost units).
+    double theoreticalMakespan() const
+    {
+        return std::max(static_cast<double>(critical_path), static_cast<double>(total_cost) / threads);
+    }
+};
+
+// Executes a DAG of tasks (arc u -> v: v depends on u) on a pool of threads.
+// A task becomes ready when its last dependency finishes (atomic in-degree
+// counters), and is pushed to the heap of the worker that freed it. Workers
+// pop their own most urgent task and steal the most urgent task of another
+// worker when they run dry.
+//
+// Urgency is the task's bottom level: its own estimated cost plus the
+// longest cost chain among the tasks that depend on it, i.e. its position
+// on the critical path (task 9 of 10/graphs).
+class TaskExecutor
+{
+public:
+    TaskExecutor(const WeightedCsrGraph& dependencies, std::vector<int64_t> costs, unsigned threads = 0);
+
+    // Calls body(task) for every task, respecting dependencies.
+    template <typename Body>
+    ExecutionReport run(Body&& body);
+
+    int64_t priority(uint32_t task) const { return bottom_level[task]; }
+    int64_t criticalPathCost() const { return critical_path; }
+
+private:
+    using Entry = std::pair<int64_t, uint32_t>; // (bottom level, task)
+
+    struct alignas(64) Worker
+    {
+        std::mutex lock;
+        std::vector<Entry> heap;
+        uint64_t steals = 0;
+    };
+
+    const WeightedCsrGraph& graph;
+    std::vector<int64_t> costs;
+    std::vector<int64_t> bottom_level;
+    std::vector<uint32_t> in_degree;
+    std::vector<uint32_t> sources;
+    int64_t critical_path = 0;
+    int64_t total_cost = 0;
+    unsigned threads;
+
+    static bool pop(Worker& worker, uint32_t& task);
+};
+
+inline TaskExecutor::TaskExecutor(const WeightedCsrGraph& dependencies, std::vector<int64_t> costs,
+                                  unsigned threads)
+    : graph(dependencies), costs(std::move(costs))
+{
+    this->threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (this->costs.empty())
+        this->costs.assign(graph.vertex_count, 1);
+    else if (this->costs.size() != graph.vertex_count)
+        throw std::invalid_argument("Task costs do not match the task count");
+
+    DagEngine dag(graph, this->threads);
+    if (!dag.isAcyclic())
+        throw std::invalid_argument("Task graph has a dependency cycle");
+
+    // Bottom levels in reverse topological order.
+    bottom_level.assign(graph.vertex_count, 0);
+    const std::vector<uint32_t>& order = dag.order();
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        uint32_t v = *it;
+        int64_t longest_after = 0;
+        for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+            longest_after = std::max(longest_after, bottom_level[graph.targets[e]]);
+        bottom_level[v] = this->costs[v] + longest_after;
+    }
+
+    in_degree.assign(graph.vertex_count, 0);
+    for (uint32_t target : graph.targets)
+        in_degree[target]++;
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        total_cost += this->costs[v];
+        if (in_degree[v] == 0)
+        {
+            sources.push_back(v);
+            critical_path = std::max(critical_path, bottom_level[v]);
+        }
+    }
+}
+
+inline bool TaskExecutor::pop(Worker& worker, uint32_t& task)
+{
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (worker.heap.empty())
+        return false;
+    std::pop_heap(worker.heap.begin(), worker.heap.end());
+    task = worker.heap.back().second;
+    worker.heap.pop_back();
+    return true;
+}
+
+template <typename Body>
+ExecutionReport TaskExecutor::run(Body&& body)
+{
+    const uint32_t n = graph.vertex_count;
+    std::unique_ptr<std::atomic<uint32_t>[]> remaining_deps(new std::atomic<uint32_t>[n]);
+    for (uint32_t v = 0; v < n; ++v)
+        remaining_deps[v].store(in_degree[v], std::memory_order_relaxed);
+
+    std::unique_ptr<Worker[]> workers(new Worker[threads]);
+    for (size_t i = 0; i < sources.size(); ++i)
+        workers[i % threads].heap.push_back({bottom_level[sources[i]], sources[i]});
+    for (unsigned t = 0; t < threads; ++t)
+        std::make_heap(workers[t].heap.begin(), workers[t].heap.end());
+
+    std::atomic<uint32_t> unfinished(n);
+
+    auto worker_loop = [&](unsigned self) {
+        Worker& own = workers[self];
+        std::vector<Entry> freed;
+        unsigned idle_rounds = 0;
+
+        while (unfinished.load(std::memory_order_acquire) > 0)
+        {
+            uint32_t task;
+            bool found = pop(own, task);
+            for (unsigned k = 1; !found && k < threads; ++k)
+            {
+                if (pop(workers[(self + k) % threads], task))
+                {
+                    found = true;
+                    own.steals++;
+                }
+            }
+
+            if (!found)
+            {
+                if (++idle_rounds > 16)
+                    std::this_thread::yield();
+                continue;
+            }
+            idle_rounds = 0;
+
+            body(task);
+
+            freed.clear();
+            for (uint64_t e = graph.edgesBegin(task); e < graph.edgesEnd(task); ++e)
+            {
+                uint32_t next = graph.targets[e];
+                if (remaining_deps[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    freed.push_back({bottom_level[next], next});
+            }
+            if (!freed.empty())
+            {
+                std::lock_guard<std::mutex> guard(own.lock);
+                for (const Entry& entry : freed)
+                {
+                    own.heap.push_back(entry);
+                    std::push_heap(own.heap.begin(), own.heap.end());
+                }
+            }
+            unfinished.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker_loop, t);
+    worker_loop(0);
+    for (auto& thread : pool)
+        thread.join();
+
+    ExecutionReport report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.tasks = n;
+    report.threads = threads;
+    report.critical_path = critical_path;
+    report.total_cost = total_cost;
+    for (unsigned t = 0; t < threads; ++t)
+        report.steals += workers[t].steals;
+    return report;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct WeightedEdge
+{
+    uint32_t from;
+    uint32_t to;
+    int64_t weight;
+};
+
+// Directed weighted graph in compressed sparse row form: the arcs leaving v
+// are targets[offsets[v]] .. targets[offsets[v + 1] - 1] with the matching
+// entries of weights.
+struct WeightedCsrGraph
+{
+    uint32_t vertex_count = 0;
+    std::vector<uint64_t> offsets; // vertex_count + 1 entries
+    std::vector<uint32_t> targets;
+    std::vector<int64_t> weights;
+
+    uint64_t edgeCount() const { return targets.size(); }
+    uint32_t outDegree(uint32_t v) const { return static_cast<uint32_t>(offsets[v + 1] - offsets[v]); }
+    uint64_t edgesBegin(uint32_t v) const { return offsets[v]; }
+    uint64_t edgesEnd(uint32_t v) const { return offsets[v + 1]; }
+
+    // Count-then-fill construction. An undirected edge list is stored as two
+    // opposite arcs.
+    static WeightedCsrGraph fromEdges(uint32_t vertex_count, const std::vector<WeightedEdge>& edges,
+                                      bool directed = true);
+
+    // Same graph with every arc reversed.
+    WeightedCsrGraph transposed() const;
+};
+
+inline WeightedCsrGraph WeightedCsrGraph::fromEdges(uint32_t vertex_count,
+                                                    const std::vector<WeightedEdge>& edges, bool directed)
+{
+    WeightedCsrGraph graph;
+    graph.vertex_count = vertex_count;
+    graph.offsets.assign(static_cast<size_t>(vertex_count) + 1, 0);
+
+    for (const WeightedEdge& edge : edges)
+    {
+        graph.offsets[edge.from + 1]++;
+        if (!directed)
+            graph.offsets[edge.to + 1]++;
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        graph.offsets[v + 1] += graph.offsets[v];
+
+    graph.targets.resize(graph.offsets[vertex_count]);
+    graph.weights.resize(graph.offsets[vertex_count]);
+    std::vector<uint64_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+
+    for (const WeightedEdge& edge : edges)
+    {
+        uint64_t slot = cursor[edge.from]++;
+        graph.targets[slot] = edge.to;
+        graph.weights[slot] = edge.weight;
+        if (!directed)
+        {
+            slot = cursor[edge.to]++;
+            graph.targets[slot] = edge.from;
+            graph.weights[slot] = edge.weight;
+        }
+    }
+    return graph;
+}
+
+inline WeightedCsrGraph WeightedCsrGraph::transposed() const
+{
+    WeightedCsrGraph result;
+    result.vertex_count = vertex_count;
+    result.offsets.assign(static_cast<size_t>(vertex_count) + 1, 0);
+    for (uint32_t target : targets)
+        result.offsets[target + 1]++;
+    for (uint32_t v = 0; v < vertex_count; ++v)
+        result.offsets[v + 1] += result.offsets[v];
+
+    result.targets.resize(targets.size());
+    result.weights.resize(weights.size());
+    std::vector<uint64_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        for (uint64_t e = offsets[v]; e < offsets[v + 1]; ++e)
+        {
+            uint64_t slot = cursor[targets[e]]++;
+            result.targets[slot] = v;
+            result.weights[slot] = weights[e];
+        }
+    }
+    return result;
+}
@@ -0,0 +1,135 @@
+// g++ -O2 -std=c++17 constrained_shortest_path.cpp -o constrained_shortest_path
+//
+//   ./constrained_shortest_path [grid side]
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ConstrainedShortestPath.hpp"
+using namespace std;
+
+// Dijkstra over (vertex, fuel used) states: the approach that explodes,
+// n * (L + 1) states. Only run when that fits in memory.
+int64_t stateExpansion(const ResourceGraph& graph, uint32_t source, uint32_t target, int64_t limit)
+{
+    const int64_t INF = numeric_limits<int64_t>::max();
+    vector<int64_t> best(graph.vertex_count * (limit + 1), INF);
+    using Item = tuple<int64_t, uint32_t, int64_t>;
+    priority_queue<Item, vector<Item>, greater<Item>> heap;
+    best[source * (limit + 1)] = 0;
+    heap.push({0, source, 0});
+    while (!heap.empty())
+    {
+        auto [distance, v, fuel] = heap.top();
+        heap.pop();
+        if (v == target)
+            return distance;
+        if (distance > best[v * (limit + 1) + fuel])
+            continue;
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e)
+        {
+            int64_t f = fuel + graph.fuels[e];
+            int64_t d = distance + graph.distances[e];
+            uint32_t u = graph.targets[e];
+            if (f <= limit && d < best[u * (limit + 1) + f])
+            {
+                best[u * (limit + 1) + f] = d;
+                heap.push({d, u, f});
+            }
+        }
+    }
+    return -1;
+}
+
+// side x side grid, random distance and fuel per edge. With highways the
+// grid also gets long "motorway" edges: short distance, expensive fuel.
+ResourceGraph makeGraph(uint32_t side, bool highways)
+{
+    mt19937_64 rng(29);
+    uniform_int_distribution<int64_t> cost(1, 100);
+    vector<ResourceEdge> edges;
+    auto id = [side](uint32_t r, uint32_t c) { return r * side + c; };
+    for (uint32_t r = 0; r < side; ++r)
+    {
+        for (uint32_t c = 0; c < side; ++c)
+        {
+            if (c + 1 < side && (!highways || rng() % 10))
+                edges.push_back({id(r, c), id(r, c + 1), cost(rng), cost(rng)});
+            if (r + 1 < side && (!highways || rng() % 10))
+                edges.push_back({id(r, c), id(r + 1, c), cost(rng), cost(rng)});
+        }
+    }
+    if (highways)
+    {
+        for (uint32_t i = 0; i < side * 2; ++i)
+        {
+            uint32_t r1 = rng() % side, c1 = rng() % side, r2 = rng() % side, c2 = rng() % side;
+            int64_t length = abs(int64_t(r1) - r2) + abs(int64_t(c1) - c2);
+            edges.push_back({id(r1, c1), id(r2, c2), length * 20, length * 120});
+        }
+    }
+    return ResourceGraph::fromEdges(side * side, edges);
+}
+
+void runCase(const string& name, const ResourceGraph& graph, uint32_t source, uint32_t target)
+{
+    // Tight budgets sit just above the fuel of the least-fuel path; the
+    // unconstrained run uses the fuel of the plain shortest path.
+    ConstrainedShortestPath solver(graph);
+    int64_t lowest = solver.minimumFuel(source, target);
+    ConstrainedPath loose = solver.solve(source, target, numeric_limits<int64_t>::max());
+
+    for (double factor : {1.05, 1.5, 0.0})
+    {
+        int64_t limit = factor > 0 ? static_cast<int64_t>(lowest * factor) : loose.fuel;
+        auto start = chrono::steady_clock::now();
+        ConstrainedPath path = solver.solve(source, target, limit);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << name << (factor > 0 ? " L = " + to_string(factor).substr(0, 4) + " x min fuel" : " L = unconstrained")
+             << ": D = " << path.distance << ", F = " << path.fuel << "/" << limit << ", " << path.vertices.size()
+             << " vertices on path, " << path.labels_created << " labels, " << seconds * 1e3 << " ms";
+
+        uint64_t states = uint64_t(graph.vertex_count) * (limit + 1);
+        if (states <= 50000000)
+        {
+            start = chrono::steady_clock::now();
+            int64_t expected = stateExpansion(graph, source, target, limit);
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << "; state expansion " << seconds * 1e3 << " ms" << (expected == path.distance ? "" : " MISMATCH");
+        }
+        else
+        {
+            cout << "; state expansion would need " << states << " states";
+        }
+        cout << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // Example of task 8 (1-based vertices shifted to 0-based).
+    ResourceGraph example = ResourceGraph::fromEdges(3, {{0, 1, 5, 6}, {1, 2, 5, 6}});
+    cout << "Task 8: " << ConstrainedShortestPath(example).solve(0, 2, 10).distance << "\n";
+    // No limit at all: 2 cannot be reached from 0, and 3 is a dead end
+    // behind a fuel-free arc.
+    ResourceGraph cut = ResourceGraph::fromEdges(4, {{0, 1, 5, 6}, {0, 3, 1, 0}, {2, 1, 1, 1}}, true);
+    ConstrainedShortestPath cut_solver(cut);
+    bool same = cut_solver.solve(0, 2, numeric_limits<int64_t>::max()).status == ConstrainedPath::Status::Unreachable &&
+                cut_solver.solve(0, 1, numeric_limits<int64_t>::max()).distance == 5;
+    cout << "unlimited fuel, unreachable target" << (same ? "" : " MISMATCH") << "\n";
+    // A long arc must not size the bucket ring.
+    ResourceGraph long_arc = ResourceGraph::fromEdges(2, {{0, 1, 1, 5}, {0, 1, 10000000000, 0}}, true);
+    same = ConstrainedShortestPath(long_arc).solve(0, 1, 3).distance == 10000000000;
+    cout << "arc of length 1e10" << (same ? "" : " MISMATCH") << "\n";
+
+    uint32_t side = argc > 1 ? stoul(argv[1]) : 300;
+    uint32_t corner = side * side - 1;
+    runCase("grid", makeGraph(side, false), 0, corner);
+    runCase("road-like", makeGraph(side, true), 0, corner);
+    return 0;
+}
@@ -0,0 +1,203 @@
+// g++ -O2 -std=c++17 heap_dijkstra.cpp -o heap_dijkstra
+//
+//   ./heap_dijkstra [vertices] [edges]
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../06_queues/PriorityQueue/IndexedDaryHeap.hpp"
+#include "../../06_queues/PriorityQueue/PairingHeap.hpp"
+#include "../../06_queues/PriorityQueue/RadixHeap.hpp"
+#include "WeightedGraph.hpp"
+using namespace std;
+
+const int64_t INF = numeric_limits<int64_t>::max();
+
+// std::priority_queue has no decrease-key: push duplicates, skip stale ones.
+vector<int64_t> lazyDijkstra(const WeightedCsrGraph& graph, uint32_t source)
+{
+    vector<int64_t> distance(graph.vertex_count, INF);
+    using Item = pair<int64_t, uint32_t>;
+    priority_queue<Item, vector<Item>, greater<Item>> heap;
+    distance[source] = 0;
+    heap.push({0, source});
+    while (!heap.empty())
+    {
+        auto [d, v] = heap.top();
+        heap.pop();
+        if (d > distance[v])
+            continue;
+        for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+        {
+            uint32_t next = graph.targets[e];
+            if (d + graph.weights[e] < distance[next])
+            {
+                distance[next] = d + graph.weights[e];
+                heap.push({distance[next], next});
+            }
+        }
+    }
+    return distance;
+}
+
+// Any heap with pushOrDecrease: every vertex is in the heap at most once.
+template <class Heap>
+vector<int64_t> indexedDijkstra(const WeightedCsrGraph& graph, uint32_t source, Heap& heap)
+{
+    vector<int64_t> distance(graph.vertex_count, INF);
+    heap.reset(graph.vertex_count);
+    distance[source] = 0;
+    heap.push(source, 0);
+    while (!heap.isEmpty())
+    {
+        uint32_t v = heap.pop();
+        for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+        {
+            uint32_t next = graph.targets[e];
+            if (distance[v] + graph.weights[e] < distance[next])
+            {
+                distance[next] = distance[v] + graph.weights[e];
+                heap.pushOrDecrease(next, distance[next]);
+            }
+        }
+    }
+    return distance;
+}
+
+vector<int64_t> radixDijkstra(const WeightedCsrGraph& graph, uint32_t source)
+{
+    vector<int64_t> distance(graph.vertex_count, INF);
+    RadixHeap<uint32_t> heap;
+    distance[source] = 0;
+    heap.push(0, source);
+    while (!heap.isEmpty())
+    {
+        auto [d, v] = heap.pop();
+        if (static_cast<int64_t>(d) > distance[v])
+            continue;
+        for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+        {
+            uint32_t next = graph.targets[e];
+            if (distance[v] + graph.weights[e] < distance[next])
+            {
+                distance[next] = distance[v] + graph.weights[e];
+                heap.push(distance[next], next);
+            }
+        }
+    }
+    return distance;
+}
+
+// Task 7: Kahn's algorithm taking the smallest free vertex every time.
+vector<uint32_t> lexicographicTopologicalOrder(const WeightedCsrGraph& graph)
+{
+    vector<uint32_t> in_degree(graph.vertex_count, 0);
+    for (uint32_t target : graph.targets)
+        in_degree[target]++;
+
+    IndexedDaryHeap<uint32_t> ready(graph.vertex_count);
+    for (uint32_t v = 0; v < graph.vertex_count; ++v)
+    {
+        if (in_degree[v] == 0)
+            ready.push(v, v);
+    }
+    vector<uint32_t> order;
+    while (!ready.isEmpty())
+    {
+        uint32_t v = ready.pop();
+        order.push_back(v);
+        for (uint64_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+        {
+            if (--in_degree[graph.targets[e]] == 0)
+                ready.push(graph.targets[e], graph.targets[e]);
+        }
+    }
+    return order;
+}
+
+// Random graph: uniform arcs plus a ring for reachability.
+WeightedCsrGraph makeRandomGraph(uint32_t n, uint64_t m)
+{
+    mt19937_64 rng(41);
+    uniform_int_distribution<int64_t> weight(1, 100000);
+    vector<WeightedEdge> edges;
+    edges.reserve(m);
+    for (uint32_t v = 0; v < n; ++v)
+        edges.push_back({v, (v + 1) % n, weight(rng)});
+    while (edges.size() < m)
+        edges.push_back({static_cast<uint32_t>(rng() % n), static_cast<uint32_t>(rng() % n), weight(rng)});
+    return WeightedCsrGraph::fromEdges(n, edges);
+}
+
+// Road-like grid: side x side, four arcs per vertex. Long shortest paths and
+// frequent decrease-key.
+WeightedCsrGraph makeGrid(uint32_t side)
+{
+    mt19937_64 rng(43);
+    uniform_int_distribution<int64_t> weight(1, 1000);
+    vector<WeightedEdge> edges;
+    for (uint32_t r = 0; r < side; ++r)
+    {
+        for (uint32_t c = 0; c < side; ++c)
+        {
+            if (c + 1 < side)
+                edges.push_back({r * side + c, r * side + c + 1, weight(rng)});
+            if (r + 1 < side)
+                edges.push_back({r * side + c, (r + 1) * side + c, weight(rng)});
+        }
+    }
+    return WeightedCsrGraph::fromEdges(side * side, edges, false);
+}
+
+void compareHeaps(const string& name, const WeightedCsrGraph& graph)
+{
+    cout << name << ": " << graph.vertex_count << " vertices, " << graph.edgeCount() << " arcs\n";
+    vector<int64_t> expected;
+
+    auto measure = [&](const string& heap_name, const function<vector<int64_t>()>& run) {
+        auto start = chrono::steady_clock::now();
+        vector<int64_t> distance = run();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (expected.empty())
+            expected = distance;
+        cout << "  " << heap_name << seconds << " s" << (distance == expected ? "" : " MISMATCH") << "\n";
+    };
+
+    IndexedDaryHeap<int64_t, 2> binary;
+    IndexedDaryHeap<int64_t, 4> quaternary;
+    IndexedDaryHeap<int64_t, 8> octonary;
+    PairingHeap<int64_t> pairing;
+    measure("std::priority_queue (lazy)  ", [&] { return lazyDijkstra(graph, 0); });
+    measure("IndexedDaryHeap<int64_t, 2> ", [&] { return indexedDijkstra(graph, 0, binary); });
+    measure("IndexedDaryHeap<int64_t, 4> ", [&] { return indexedDijkstra(graph, 0, quaternary); });
+    measure("IndexedDaryHeap<int64_t, 8> ", [&] { return indexedDijkstra(graph, 0, octonary); });
+    measure("RadixHeap                   ", [&] { return radixDijkstra(graph, 0); });
+    measure("PairingHeap                 ", [&] { return indexedDijkstra(graph, 0, pairing); });
+}
+
+int main(int argc, char** argv)
+{
+    // Examples of tasks 1, 2 and 7 (1-based vertices shifted to 0-based).
+    WeightedCsrGraph task1 = WeightedCsrGraph::fromEdges(3, {{0, 1, 5}, {0, 2, 10}, {1, 2, 2}});
+    IndexedDaryHeap<int64_t> heap;
+    cout << "Task 1:";
+    for (int64_t d : indexedDijkstra(task1, 0, heap))
+        cout << " " << (d == INF ? -1 : d);
+    WeightedCsrGraph task2 = WeightedCsrGraph::fromEdges(4, {{0, 1, 100}, {1, 3, 500}, {0, 2, 200}, {2, 3, 150}});
+    cout << "\nTask 2: " << radixDijkstra(task2, 0)[3] << "\nTask 7:";
+    WeightedCsrGraph task7 = WeightedCsrGraph::fromEdges(4, {{2, 0, 1}, {1, 0, 1}});
+    for (uint32_t v : lexicographicTopologicalOrder(task7))
+        cout << " " << v + 1;
+    cout << "\n\n";
+
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    uint64_t m = argc > 2 ? stoull(argv[2]) : 10000000;
+    compareHeaps("random", makeRandomGraph(n, m));
+    compareHeaps("grid", makeGrid(static_cast<uint32_t>(sqrt(m / 4.0))));
+    return 0;
+}
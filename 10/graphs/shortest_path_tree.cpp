@@ -0,0 +1,110 @@
+// g++ -O2 -std=c++17 shortest_path_tree.cpp -o shortest_path_tree
+//
+//   ./shortest_path_tree [vertices] [path queries]
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ShortestPathTree.hpp"
+using namespace std;
+
+// Sparse random graph with a ring through all vertices (so everything is
+// reachable) and three random arcs per vertex.
+WeightedCsrGraph makeGraph(uint32_t n)
+{
+    mt19937_64 rng(31);
+    uniform_int_distribution<int64_t> weight(1, 1000);
+    vector<WeightedEdge> edges;
+    edges.reserve(uint64_t(n) * 4);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        edges.push_back({v, (v + 1) % n, weight(rng)});
+        for (int k = 0; k < 3; ++k)
+            edges.push_back({v, static_cast<uint32_t>(rng() % n), weight(rng)});
+    }
+    return WeightedCsrGraph::fromEdges(n, edges);
+}
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    // Example of task 3 (1-based vertices shifted to 0-based).
+    WeightedCsrGraph example = WeightedCsrGraph::fromEdges(3, {{0, 1, 5}, {1, 2, 10}, {0, 2, 20}});
+    WeightedCsrGraph example_reverse = example.transposed();
+    cout << "Task 3:";
+    for (uint32_t v : ShortestPathTree(example, example_reverse, 0).path(2))
+        cout << " " << v + 1;
+    cout << "\n\n";
+
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 5000000;
+    uint64_t queries = argc > 2 ? stoull(argv[2]) : 10000000;
+
+    WeightedCsrGraph graph = makeGraph(n);
+    WeightedCsrGraph reverse = graph.transposed();
+    cout << n << " vertices, " << graph.edgeCount() << " arcs, " << queries << " path queries\n";
+
+    mt19937_64 rng(37);
+    vector<uint32_t> targets(queries);
+    for (uint32_t& target : targets)
+        target = rng() % n;
+
+    for (ParentEncoding encoding : {ParentEncoding::VertexId, ParentEncoding::ArcRank})
+    {
+        auto start = chrono::steady_clock::now();
+        ShortestPathTree tree(graph, reverse, 0, encoding);
+        double build = secondsSince(start);
+
+        // One vector per path, as a straightforward implementation returns.
+        start = chrono::steady_clock::now();
+        uint64_t naive_vertices = 0;
+        for (uint32_t target : targets)
+            naive_vertices += tree.path(target).size();
+        double naive = secondsSince(start);
+
+        // All paths into one reused flat buffer, in batches.
+        const size_t batch_size = 4096;
+        PathBatch batch;
+        uint64_t batch_vertices = 0;
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < targets.size(); i += batch_size)
+        {
+            batch.clear();
+            tree.extractPaths(targets.data() + i, min(batch_size, targets.size() - i), batch);
+            batch_vertices += batch.vertices.size();
+        }
+        double batched = secondsSince(start);
+
+        cout << (encoding == ParentEncoding::VertexId ? "vertex ids: " : "arc ranks:  ") << tree.parentBytes() / 1e6
+             << " MB predecessors, Dijkstra " << build << " s; " << naive_vertices / double(queries)
+             << " vertices per path; vector per path " << naive / queries * 1e9 << " ns/query, batched "
+             << batched / queries * 1e9 << " ns/query" << (naive_vertices == batch_vertices ? "" : " MISMATCH")
+             << "\n";
+    }
+
+    // Route queries from a few hot sources: the cache answers repeats from
+    // stored trees instead of running Dijkstra again.
+    const uint32_t hot_sources = 6;
+    const uint64_t cached_queries = 60;
+    ShortestPathCache cache(graph, 4, ParentEncoding::ArcRank);
+    uniform_int_distribution<uint32_t> pick(0, hot_sources * hot_sources - 1);
+    uint64_t total_length = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint64_t q = 0; q < cached_queries; ++q)
+    {
+        // Squared index: low sources are much more popular.
+        uint32_t source = static_cast<uint32_t>(hot_sources - 1 - static_cast<uint32_t>(sqrt(double(pick(rng)))));
+        total_length += cache.path(source * 7919 % n, targets[q]).size();
+    }
+    double seconds = secondsSince(start);
+    cout << "LRU of 4 trees, " << hot_sources << " hot sources: " << cached_queries << " queries in " << seconds
+         << " s, " << cache.hits() << " hits, " << cache.misses() << " Dijkstra runs, " << total_length
+         << " path vertices\n";
+    return 0;
+}
@@ -0,0 +1,82 @@
+// g++ -O2 -std=c++17 -pthread task_executor.cpp -o task_executor
+//
+//   ./task_executor [tasks] [dependencies per task] [threads]
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TaskExecutor.hpp"
+using namespace std;
+
+// Layered synthetic DAG: every task depends on a few tasks of the previous
+// layers, costs are 0.5-5 us with occasional 50 us outliers.
+WeightedCsrGraph makeTaskGraph(uint32_t n, uint32_t fan_in, vector<int64_t>& cost_ns)
+{
+    mt19937_64 rng(23);
+    const uint32_t layer = 1000;
+    vector<WeightedEdge> edges;
+    edges.reserve(uint64_t(n) * fan_in);
+    cost_ns.resize(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        cost_ns[v] = rng() % 100 == 0 ? 50000 : 500 + rng() % 4500;
+        if (v < layer)
+            continue;
+        for (uint32_t k = 0; k < fan_in; ++k)
+            edges.push_back({static_cast<uint32_t>(v - 1 - rng() % min(v, 2 * layer)), v, 0});
+    }
+    return WeightedCsrGraph::fromEdges(n, edges);
+}
+
+void spinFor(int64_t nanoseconds)
+{
+    auto until = chrono::steady_clock::now() + chrono::nanoseconds(nanoseconds);
+    while (chrono::steady_clock::now() < until)
+    {
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    uint32_t fan_in = argc > 2 ? stoul(argv[2]) : 3;
+    unsigned threads = argc > 3 ? stoul(argv[3]) : thread::hardware_concurrency();
+
+    vector<int64_t> cost_ns;
+    WeightedCsrGraph graph = makeTaskGraph(n, fan_in, cost_ns);
+    TaskExecutor executor(graph, cost_ns, threads);
+
+    // A cost list for a different number of tasks is rejected.
+    bool rejected = false;
+    try
+    {
+        TaskExecutor(graph, vector<int64_t>(n + 1, 1), threads);
+    }
+    catch (const invalid_argument&)
+    {
+        rejected = true;
+    }
+    if (!rejected)
+        cout << "costs of the wrong length accepted MISMATCH\n";
+
+    // Empty tasks: everything measured is scheduling overhead.
+    atomic<uint64_t> checksum(0);
+    ExecutionReport empty = executor.run([&](uint32_t task) {
+        checksum.fetch_add(task, memory_order_relaxed);
+    });
+    cout << n << " tasks, " << graph.edgeCount() << " dependencies, " << empty.threads << " threads\n";
+    cout << "empty tasks: " << empty.seconds << " s, " << empty.seconds * empty.threads / n * 1e9
+         << " ns scheduling overhead per task, " << empty.steals << " steals\n";
+
+    // Tasks that spin for their estimated cost: achieved vs theoretical.
+    ExecutionReport real = executor.run([&](uint32_t task) { spinFor(cost_ns[task]); });
+    cout << "spinning tasks: achieved makespan " << real.seconds << " s, theoretical "
+         << real.theoreticalMakespan() / 1e9 << " s (critical path " << real.critical_path / 1e9
+         << " s, work / threads " << real.total_cost / 1e9 / real.threads << " s), " << real.steals
+         << " steals\n";
+    return 0;
+}